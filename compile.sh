@@ -2,25 +2,43 @@
 
 set -e
 
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/byte_ring.o src/internal/byte_ring.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/command.o src/internal/command.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/futex.o src/internal/futex.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/hash_ring.o src/internal/hash_ring.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/min_heap.o src/internal/min_heap.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/mpmc_ring.o src/internal/mpmc_ring.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/spsc_ring.o src/internal/spsc_ring.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/internal/util.o src/internal/util.c
 
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/arena.o src/arena.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/channel.o src/channel.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/command.o src/command.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/load_balance.o src/load_balance.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/observable.o src/observable.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/observer.o src/observer.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/retry.o src/retry.c
 /usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/scheduler.o src/scheduler.c
+/usr/bin/gcc -c -Iinclude -fPIC -ggdb3 -o src/strategy.o src/strategy.c
 
 /usr/bin/gcc -shared -o libexec/libhyperfunnel.so \
+  src/internal/byte_ring.o \
   src/internal/command.o \
+  src/internal/futex.o \
+  src/internal/hash_ring.o \
+  src/internal/min_heap.o \
+  src/internal/mpmc_ring.o \
+  src/internal/spsc_ring.o \
   src/internal/util.o \
+  src/arena.o \
   src/channel.o \
   src/command.o \
   src/load_balance.o \
   src/observable.o \
   src/observer.o \
-  src/scheduler.o
+  src/retry.o \
+  src/scheduler.o \
+  src/strategy.o
 
 
 
@@ -28,4 +46,10 @@ set -e
 /usr/bin/gcc -c -Iinclude -ggdb3 -o examples/basic.o examples/basic.c
 /usr/bin/gcc -Llibexec -o bin/basic examples/basic.o -lpthread -ljemalloc -lturnpike -lhyperfunnel
 
-rm -rf examples/*.o src/*.o src/**/*.o
+/usr/bin/gcc -c -Iinclude -ggdb3 -o examples/epoll.o examples/epoll.c
+/usr/bin/gcc -Llibexec -o bin/epoll examples/epoll.o -lpthread -ljemalloc -lturnpike -lhyperfunnel
+
+/usr/bin/gcc -c -Iinclude -ggdb3 -o test/retry.o test/retry.c
+/usr/bin/gcc -Llibexec -o bin/test_retry test/retry.o -lpthread -ljemalloc -lturnpike -lhyperfunnel
+
+rm -rf examples/*.o src/*.o src/**/*.o test/*.o
@@ -0,0 +1,174 @@
+#include "arena.h"
+#include "channel.h"
+#include "observable.h"
+#include "observer.h"
+#include "scheduler.h"
+
+#include <sys/epoll.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+atomic_long sum = 0;
+
+#define RECEIVE_BATCH   64
+
+static void drain(observer_t *observer)
+{
+  void *items[RECEIVE_BATCH];
+  size_t n;
+  size_t j;
+
+  int failure;
+
+  observer_rearm(observer);
+
+  /**
+   * @note An empty receive with a failure other than
+   *       SCHEDULER_FAILURE_SUCCESSFUL only means the scheduler was busy.
+   *       The eventfd is already consumed, so stopping there would strand
+   *       the items until the next publish.
+   */
+  for (;;)
+  {
+    n = observer_receive_batch(observer, items, RECEIVE_BATCH, &failure);
+
+    if (n == 0UL)
+    {
+      if (failure == SCHEDULER_FAILURE_SUCCESSFUL)
+      {
+        break;
+      }
+
+      sched_yield();
+      continue;
+    }
+
+    for (j = 0; j < n; j++)
+    {
+      atomic_fetch_add(&sum, *(int *)items[j]);
+      arena_free(arena_self(), items[j], sizeof(int));
+    }
+
+    while (false == observer_ack(observer, (int)n))
+    {
+      sched_yield();
+    }
+  }
+}
+
+void *event_loop(void *args)
+{
+  observable_t *observable = (observable_t *)args;
+
+  struct epoll_event events[2];
+  struct epoll_event event;
+
+  int epfd;
+  int n;
+  int j;
+
+  uint64_t i;
+
+  if ((epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not create epoll instance");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0; i < observable->count; i++)
+  {
+    event.events = EPOLLIN;
+    event.data.ptr = observable->observers[i];
+
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, observer_fd(observable->observers[i]), &event) < 0)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not watch observer");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  while (false == atomic_load(&observable->done))
+  {
+    if ((n = epoll_wait(epfd, events, 2, -1)) < 0)
+    {
+      continue;
+    }
+
+    for (j = 0; j < n; j++)
+    {
+      drain((observer_t *)events[j].data.ptr);
+    }
+  }
+
+  close(epfd);
+
+  return NULL;
+}
+
+#define WORK_LOAD       100000UL
+#define QUEUE_CAPACITY  WORK_LOAD * sizeof(int)
+#define MAX_OBSERVERS   2
+#define MAX_THREADS     1
+
+/**
+ * @note Both observers share one thread that sleeps in epoll_wait until
+ *       the eventfd of either channel turns readable.
+ */
+int main(void)
+{
+  observable_t *observable = NULL;
+  observable = observable_new(QUEUE_CAPACITY, MAX_OBSERVERS, MAX_THREADS,
+    OBSERVABLE_FLAG_SHARDED | OBSERVABLE_FLAG_SPSC | OBSERVABLE_FLAG_EVENTFD);
+
+  observable_subscribe(observable, observer_new(observable, observable->channels[0], NULL, 0));
+  observable_subscribe(observable, observer_new(observable, observable->channels[1], NULL, 1));
+
+  pthread_t tid;
+  uint64_t i;
+
+  int *data = NULL;
+
+  if (pthread_create(&tid, NULL, &event_loop, observable) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not create thread");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 1; i < WORK_LOAD; i++)
+  {
+    data = (int *)arena_malloc(arena_self(), sizeof(*data));
+    *data = 1;
+
+    if (false == observable_publish(observable, data))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not publish to workers");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (false == observable_cleanup(observable))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not clean-up observable publishing");
+    exit(EXIT_FAILURE);
+  }
+
+  observable_shutdown(observable, -1L);
+
+  if (pthread_join(tid, NULL) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not join thread");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("%ld\n", atomic_load(&sum));
+
+  observable_destroy(observable);
+
+  return EXIT_FAILURE;
+}
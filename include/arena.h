@@ -0,0 +1,79 @@
+#ifndef HYPER_FUNNEL__ARENA_H
+#define HYPER_FUNNEL__ARENA_H
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define ARENA_RECYCLE_MAX 256
+
+/**
+ * @brief Counters of an arena. Bytes are the sizes the caller asked for,
+ *        frees of unknown size only count towards deallocations.
+ */
+struct arena_stats
+{
+  uint64_t allocations;
+  uint64_t deallocations;
+  uint64_t bytes_allocated;
+  uint64_t bytes_freed;
+};
+
+typedef struct arena_stats arena_stats_t;
+
+/**
+ * @brief A dedicated jemalloc arena with its own explicit thread cache.
+ *        Payloads a publisher allocates from its arena never share bins
+ *        with another thread, and an observer that frees them through its
+ *        own arena batches the return in its cache instead of contending
+ *        on the default arena.
+ *
+ * @note  An arena belongs to the thread that allocates and frees through
+ *        it. Only the counters may be read from elsewhere.
+ */
+struct arena
+{
+  unsigned index;
+  unsigned tcache;
+  int flags;
+  atomic_uint_fast64_t allocations;
+  atomic_uint_fast64_t deallocations;
+  atomic_uint_fast64_t bytes_allocated;
+  atomic_uint_fast64_t bytes_freed;
+};
+
+typedef struct arena arena_t;
+
+arena_t *arena_new(void);
+
+/**
+ * @note The jemalloc arena outlives this call: its unused pages are
+ *       purged and its index is handed to the next arena_new. Memory still
+ *       allocated from it stays valid and from then on shares the arena
+ *       with the allocations of its next owner; it may be freed through
+ *       any arena.
+ */
+void arena_destroy(arena_t *self);
+
+/**
+ * @brief The arena of the calling thread, created on first use and
+ *        destroyed when the thread exits.
+ */
+arena_t *arena_self(void);
+
+/**
+ * @brief Fast path, the memory is not zeroed.
+ */
+void *arena_malloc(arena_t *self, const size_t size);
+
+void *arena_calloc(arena_t *self, const size_t nmemb, const size_t size);
+
+/**
+ * @brief Free memory from any arena through the cache of this one. Pass
+ *        the size given at allocation for a sized free, or 0 if unknown.
+ */
+void arena_free(arena_t *self, void *ptr, const size_t size);
+
+void arena_stats(arena_t *self, arena_stats_t *stats);
+
+#endif/*HYPER_FUNNEL__ARENA_H*/
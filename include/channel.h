@@ -1,12 +1,41 @@
 #ifndef HYPER_FUNNEL__CHANNEL_H
 #define HYPER_FUNNEL__CHANNEL_H
 
+#include "internal/byte_ring.h"
+#include "internal/spsc_ring.h"
+
 #include <turnpike/bipartite.h>
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum
+{
+  CHANNEL_DOWNSTREAM,
+  CHANNEL_UPSTREAM,
+};
+
+#define CHANNEL_PRIORITY_BANDS 4
+
+/**
+ * @note The record rings are only allocated by
+ *       bidirectional_channel_new_records, the pointer rings only by
+ *       bidirectional_channel_spsc and the priority bands only by
+ *       bidirectional_channel_priority; all are NULL otherwise. Each
+ *       direction has exactly one writer and one reader. eventfd is -1
+ *       unless bidirectional_channel_eventfd was called.
+ */
 struct bidirectional_channel
 {
   bipartite_queue_t *downstream;
   bipartite_queue_t *upstream;
+  byte_ring_t *downstream_records;
+  byte_ring_t *upstream_records;
+  spsc_ring_t *downstream_ring;
+  spsc_ring_t *upstream_ring;
+  spsc_ring_t *bands[CHANNEL_PRIORITY_BANDS];
+  int eventfd;
 };
 
 typedef struct bidirectional_channel bidirectional_channel_t;
@@ -14,6 +43,99 @@ typedef struct bidirectional_channel bidirectional_channel_t;
 bidirectional_channel_t *bidirectional_channel_new(const size_t downstream_capacity,
                                                    const size_t upstream_capacity);
 
+/**
+ * @brief Same as bidirectional_channel_new, plus a byte ring of
+ *        record_capacity bytes per direction for inline variable-size
+ *        records.
+ */
+bidirectional_channel_t *bidirectional_channel_new_records(const size_t downstream_capacity,
+                                                           const size_t upstream_capacity,
+                                                           const size_t record_capacity);
+
 void bidirectional_channel_destroy(bidirectional_channel_t *self);
 
+/**
+ * @brief Give the channel a single-producer/single-consumer pointer ring
+ *        per direction. Items then move between the publisher and the
+ *        observer with one release store each way and never touch the
+ *        scheduler.
+ */
+void bidirectional_channel_spsc(bidirectional_channel_t *self, const size_t downstream_capacity,
+                                const size_t upstream_capacity);
+
+/**
+ * @brief Give the channel a non-blocking eventfd that channel_notify
+ *        signals, so the downstream side can be watched from an epoll or
+ *        poll loop.
+ */
+void bidirectional_channel_eventfd(bidirectional_channel_t *self);
+
+/**
+ * @brief Signal the eventfd of the channel, if any.
+ */
+void channel_notify(bidirectional_channel_t *self);
+
+/**
+ * @brief Reset the eventfd of the channel, if any, to not readable.
+ */
+void channel_rearm(bidirectional_channel_t *self);
+
+/**
+ * @brief Give the downstream direction CHANNEL_PRIORITY_BANDS pointer rings
+ *        of capacity items each. Items in a band overtake everything in
+ *        the lower bands and in the regular downstream queue.
+ */
+void bidirectional_channel_priority(bidirectional_channel_t *self, const size_t capacity);
+
+/**
+ * @brief Push an item into the band for prio; priorities beyond the last
+ *        band share it. Returns false when the band is full or the channel
+ *        has no bands.
+ */
+bool channel_send_priority(bidirectional_channel_t *self, const uint32_t prio, const void *data);
+
+/**
+ * @brief Pop up to max items, highest band first. Returns the number of
+ *        items stored in out.
+ */
+size_t channel_receive_priority(bidirectional_channel_t *self, void **out, const size_t max);
+
+/**
+ * @brief Number of items waiting in the priority bands.
+ */
+size_t channel_priority_size(bidirectional_channel_t *self);
+
+/**
+ * @brief Copy a record of len bytes into the ring of the given direction.
+ *        Returns false when the ring is full or the channel has no rings.
+ */
+bool channel_send(bidirectional_channel_t *self, const int direction, const void *data, const size_t len);
+
+/**
+ * @brief Copy the oldest record of the given direction into out. On entry
+ *        *len holds the size of out, on return the length of the record.
+ */
+bool channel_receive(bidirectional_channel_t *self, const int direction, void *out, size_t *len);
+
+/**
+ * @brief Claim room for a record of up to len bytes directly in the ring
+ *        of the given direction. Returns NULL when the ring is full. The
+ *        record stays invisible to the reader until channel_commit.
+ */
+void *channel_reserve(bidirectional_channel_t *self, const int direction, const size_t len);
+
+/**
+ * @note len may be smaller than the reservation. Returns false when it is
+ *       larger or nothing is reserved.
+ */
+bool channel_commit(bidirectional_channel_t *self, const int direction, const size_t len);
+
+/**
+ * @brief Oldest record of the given direction, read in place. It stays
+ *        valid until channel_release. Returns NULL when there is none.
+ */
+const void *channel_peek(bidirectional_channel_t *self, const int direction, size_t *len);
+
+void channel_release(bidirectional_channel_t *self, const int direction);
+
 #endif/*HYPER_FUNNEL__CHANNEL_H*/
@@ -27,6 +27,21 @@ static void *_calloc(const size_t nmemb, const size_t size)
   return __ptr;
 }
 
+/**
+ * @note No MALLOCX_ZERO, for buffers that are fully written before they
+ *       are read.
+ */
+static inline void *_malloc(const size_t size)
+{
+  void *__ptr = NULL;
+  __ptr = mallocx(size, 0);
+  if (__ptr == NULL)
+  {
+    die("a memory error occurred");
+  }
+  return __ptr;
+}
+
 static void _free(void **__ptr)
 {
   if (NULL != __ptr && NULL != *__ptr)
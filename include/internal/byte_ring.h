@@ -0,0 +1,91 @@
+#ifndef HYPER_FUNNEL__INTERNAL__BYTE_RING_H
+#define HYPER_FUNNEL__INTERNAL__BYTE_RING_H
+
+#include "ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#define BYTE_RING_HEADER   sizeof(uint64_t)
+#define BYTE_RING_WRAP     UINT64_MAX
+#define BYTE_RING_NONE     SIZE_MAX
+
+/**
+ * @brief Single-producer/single-consumer ring of variable-size records
+ *        stored inline. Every record is an 8 byte length followed by the
+ *        payload padded to 8 bytes. A record that would straddle the end
+ *        of the buffer is preceded by a wrap marker and starts over at
+ *        offset zero, so a payload is always contiguous.
+ *
+ * @note  The cursors are hf_ring_cursors_t counting bytes. Records are
+ *        counted separately, each side next to its own state.
+ */
+struct byte_ring
+{
+  uint8_t *buffer;
+  size_t mask;
+  char pad0[HF_RING_CACHE_LINE];
+  hf_ring_cursors_t cursors;
+  atomic_size_t committed;
+  size_t reserved;
+  size_t reserved_len;
+  char pad1[HF_RING_CACHE_LINE - sizeof(atomic_size_t) - (2 * sizeof(size_t))];
+  atomic_size_t released;
+  char pad2[HF_RING_CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+typedef struct byte_ring byte_ring_t;
+
+/**
+ * @note The capacity in bytes is rounded up to the next power of two.
+ */
+byte_ring_t *byte_ring_new(const size_t cap);
+
+void byte_ring_destroy(byte_ring_t *self);
+
+/**
+ * @brief Largest payload the ring accepts.
+ */
+size_t byte_ring_max_record(const byte_ring_t *self);
+
+/**
+ * @brief Claim room for a record of up to len bytes and return where its
+ *        payload goes, or NULL when the ring is full. Nothing is visible
+ *        to the consumer until byte_ring_commit.
+ */
+void *byte_ring_reserve(byte_ring_t *self, const size_t len);
+
+/**
+ * @note len may be smaller than the reservation; the rest is given back.
+ *       Returns false, and keeps the reservation, when len is larger or
+ *       nothing is reserved.
+ */
+bool byte_ring_commit(byte_ring_t *self, const size_t len);
+
+/**
+ * @brief Oldest record, left in place until byte_ring_release. Returns
+ *        NULL when the ring is empty.
+ */
+const void *byte_ring_peek(byte_ring_t *self, size_t *len);
+
+void byte_ring_release(byte_ring_t *self);
+
+bool byte_ring_write(byte_ring_t *self, const void *data, const size_t len);
+
+/**
+ * @brief Copy the oldest record into out. On entry *len holds the size of
+ *        out, on return the length of the record. Returns false when the
+ *        ring is empty (*len is 0) or out is too small (the record stays).
+ */
+bool byte_ring_read(byte_ring_t *self, void *out, size_t *len);
+
+/**
+ * @brief Number of records committed and not yet released.
+ */
+size_t byte_ring_size(byte_ring_t *self);
+
+bool byte_ring_empty(byte_ring_t *self);
+
+#endif/*HYPER_FUNNEL__INTERNAL__BYTE_RING_H*/
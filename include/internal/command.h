@@ -1,10 +1,13 @@
 #ifndef HYPER_FUNNEL__INTERNAL_COMMAND_H
 #define HYPER_FUNNEL__INTERNAL_COMMAND_H
 
+#include "internal/mpmc_ring.h"
+
 #include <turnpike/bipartite.h>
 #include <turnpike/queue.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 
 enum
 {
@@ -19,6 +22,13 @@ enum
   COMMAND_TYPE_READ,
 };
 
+enum
+{
+  COMMAND_RESULT_NONE,
+  COMMAND_RESULT_SUCCESS,
+  COMMAND_RESULT_FAILURE,
+};
+
 struct command;
 
 typedef void *(*command_callback_t)(struct command *command,
@@ -27,9 +37,11 @@ typedef void *(*command_callback_t)(struct command *command,
 struct command
 {
   int status;
+  int result;
   uint64_t channel_id;
   command_callback_t callback;
   void *parameter;
+  size_t count;
 };
 
 typedef struct command command_t;
@@ -38,16 +50,55 @@ command_t *command_new(const int status, const uint64_t channel_id, command_call
 
 void command_destroy(command_t *self);
 
+/**
+ * @brief Fixed slab of commands recycled through a lock-free free list,
+ *        so scheduling a command does not touch the heap. When the slab
+ *        is exhausted the pool falls back to command_new.
+ */
+struct command_pool
+{
+  command_t *slab;
+  size_t cap;
+  mpmc_ring_t *free;
+};
+
+typedef struct command_pool command_pool_t;
+
+command_pool_t *command_pool_new(const size_t cap);
+
+void command_pool_destroy(command_pool_t *self);
+
+command_t *command_pool_acquire(command_pool_t *self, const int status, const uint64_t channel_id, command_callback_t callback, const void *parameter);
+
+void command_pool_release(command_pool_t *self, command_t *command);
+
 void command_print(const command_t *self);
 
 /**
- * @note This method is inherently protected by the scheduler.
+ * @note This method is inherently protected by the scheduler. It returns
+ *       the heap copy the queue makes of the oldest item, or NULL; the
+ *       caller frees it.
  */
 void *command_read(command_t *self, bipartite_queue_t *queue, const bool probe);
 
 /**
- * @note This method is inherently protected by the scheduler.
+ * @note This method is inherently protected by the scheduler. The
+ *       parameter is an output array of count slots; on return count
+ *       holds the number of items that were read into it.
+ */
+void *command_read_many(command_t *self, bipartite_queue_t *queue, const bool probe);
+
+/**
+ * @note This method is inherently protected by the scheduler. The outcome
+ *       is stored in the result field of the command.
  */
 void *command_write(command_t *self, bipartite_queue_t *queue, const bool probe);
 
+/**
+ * @note This method is inherently protected by the scheduler. The
+ *       parameter is an array of count items; on return count holds
+ *       the number of leading items that were written.
+ */
+void *command_write_many(command_t *self, bipartite_queue_t *queue, const bool probe);
+
 #endif/*HYPER_FUNNEL__INTERNAL_COMMAND_H*/
@@ -0,0 +1,23 @@
+#ifndef HYPER_FUNNEL__INTERNAL__FUTEX_H
+#define HYPER_FUNNEL__INTERNAL__FUTEX_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Park the calling thread for as long as the word still holds the
+ *        expected value. Returns on a wake-up, a signal, or a spurious
+ *        wake-up; the caller must re-check its condition.
+ */
+void futex_wait(atomic_uint *word, const unsigned int expected);
+
+/**
+ * @brief Same as futex_wait, bounded by a relative timeout. Returns false
+ *        once the timeout has expired.
+ */
+bool futex_wait_timed(atomic_uint *word, const unsigned int expected, const struct timespec *timeout);
+
+void futex_wake(atomic_uint *word, const int count);
+
+#endif/*HYPER_FUNNEL__INTERNAL__FUTEX_H*/
@@ -0,0 +1,46 @@
+#ifndef HYPER_FUNNEL__INTERNAL__HASH_RING_H
+#define HYPER_FUNNEL__INTERNAL__HASH_RING_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HASH_RING_REPLICAS 64
+
+struct hash_ring_node
+{
+  uint64_t hash;
+  uint64_t id;
+};
+
+/**
+ * @brief Consistent-hash ring. Every member is placed on the ring at
+ *        HASH_RING_REPLICAS points and a key belongs to the first point
+ *        at or after its own hash, so adding or removing one of n members
+ *        only moves about 1/n of the keys.
+ */
+struct hash_ring
+{
+  struct hash_ring_node *nodes;
+  size_t count;
+  size_t cap;
+};
+
+typedef struct hash_ring hash_ring_t;
+
+hash_ring_t *hash_ring_new(const size_t max_members);
+
+void hash_ring_destroy(hash_ring_t *self);
+
+bool hash_ring_add(hash_ring_t *self, const uint64_t id);
+
+bool hash_ring_remove(hash_ring_t *self, const uint64_t id);
+
+/**
+ * @note Returns false when the ring has no members.
+ */
+bool hash_ring_lookup(const hash_ring_t *self, const uint64_t key, uint64_t *id);
+
+uint64_t hash_ring_hash(uint64_t x);
+
+#endif/*HYPER_FUNNEL__INTERNAL__HASH_RING_H*/
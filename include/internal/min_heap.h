@@ -0,0 +1,31 @@
+#ifndef HYPER_FUNNEL__INTERNAL__MIN_HEAP_H
+#define HYPER_FUNNEL__INTERNAL__MIN_HEAP_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/**
+ * @brief Indexed binary min-heap over an external array of keys. The
+ *        heap never owns the keys; after keys[i] changes the owner calls
+ *        min_heap_update(i) to restore the order in O(log n). Ties are
+ *        broken by the lower index, which matches lru().
+ */
+struct min_heap
+{
+  const uint64_t *keys;
+  uint64_t *heap;
+  uint64_t *index;
+  size_t size;
+};
+
+typedef struct min_heap min_heap_t;
+
+min_heap_t *min_heap_new(const uint64_t *keys, const size_t size);
+
+void min_heap_destroy(min_heap_t *self);
+
+uint64_t min_heap_peek(const min_heap_t *self);
+
+void min_heap_update(min_heap_t *self, const uint64_t i);
+
+#endif/*HYPER_FUNNEL__INTERNAL__MIN_HEAP_H*/
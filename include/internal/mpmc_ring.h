@@ -0,0 +1,53 @@
+#ifndef HYPER_FUNNEL__INTERNAL__MPMC_RING_H
+#define HYPER_FUNNEL__INTERNAL__MPMC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MPMC_RING_CACHE_LINE 64
+
+struct mpmc_ring_cell
+{
+  atomic_size_t sequence;
+  void *data;
+};
+
+/**
+ * @brief Bounded multi-producer/multi-consumer ring. Every slot carries
+ *        a sequence number which tells a producer whether the slot is
+ *        free for the current lap and a consumer whether it has been
+ *        published, so both cursors advance with a single CAS and no
+ *        lock is ever taken.
+ *
+ * @note  NULL cannot be stored, it is the empty result of a dequeue.
+ */
+struct mpmc_ring
+{
+  struct mpmc_ring_cell *cells;
+  size_t mask;
+  char pad0[MPMC_RING_CACHE_LINE];
+  atomic_size_t enqueue_pos;
+  char pad1[MPMC_RING_CACHE_LINE - sizeof(atomic_size_t)];
+  atomic_size_t dequeue_pos;
+  char pad2[MPMC_RING_CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+typedef struct mpmc_ring mpmc_ring_t;
+
+/**
+ * @note The capacity is rounded up to the next power of two.
+ */
+mpmc_ring_t *mpmc_ring_new(const size_t cap);
+
+void mpmc_ring_destroy(mpmc_ring_t *self);
+
+bool mpmc_ring_enqueue(mpmc_ring_t *self, const void *data);
+
+void *mpmc_ring_dequeue(mpmc_ring_t *self);
+
+size_t mpmc_ring_size(mpmc_ring_t *self);
+
+bool mpmc_ring_empty(mpmc_ring_t *self);
+
+#endif/*HYPER_FUNNEL__INTERNAL__MPMC_RING_H*/
@@ -0,0 +1,49 @@
+#ifndef HYPER_FUNNEL__INTERNAL__SPSC_RING_H
+#define HYPER_FUNNEL__INTERNAL__SPSC_RING_H
+
+#include "ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Bounded single-producer/single-consumer ring of pointers, the
+ *        run-time capacity counterpart of an HF_DEFINE_RING ring. The
+ *        common case touches no shared cache line and never retries.
+ *
+ * @note  Unlike mpmc_ring, NULL is a valid element.
+ */
+struct spsc_ring
+{
+  void **items;
+  size_t mask;
+  char pad0[HF_RING_CACHE_LINE];
+  hf_ring_cursors_t cursors;
+};
+
+typedef struct spsc_ring spsc_ring_t;
+
+/**
+ * @note The capacity is rounded up to the next power of two.
+ */
+spsc_ring_t *spsc_ring_new(const size_t cap);
+
+void spsc_ring_destroy(spsc_ring_t *self);
+
+bool spsc_ring_push(spsc_ring_t *self, void *item);
+
+bool spsc_ring_pop(spsc_ring_t *self, void **out);
+
+/**
+ * @brief Push the leading items that fit, returns how many were pushed.
+ */
+size_t spsc_ring_push_many(spsc_ring_t *self, void *const *items, const size_t n);
+
+size_t spsc_ring_pop_many(spsc_ring_t *self, void **out, const size_t max);
+
+size_t spsc_ring_size(spsc_ring_t *self);
+
+bool spsc_ring_empty(spsc_ring_t *self);
+
+#endif/*HYPER_FUNNEL__INTERNAL__SPSC_RING_H*/
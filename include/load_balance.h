@@ -2,32 +2,113 @@
 #define HYPER_FUNNEL__LOAD_BALANCER_H
 
 #include "channel.h"
+#include "internal/hash_ring.h"
+#include "retry.h"
 #include "scheduler.h"
-
-#include <turnpike/queue.h>
+#include "strategy.h"
 
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 
+#define LOAD_BALANCER_RESERVED_NONE UINT64_MAX
+
+enum
+{
+  LOAD_BALANCER_POLICY_LEAST_LOADED,
+  LOAD_BALANCER_POLICY_TWO_CHOICES,
+  LOAD_BALANCER_POLICY_ROUND_ROBIN,
+  LOAD_BALANCER_POLICY_WEIGHTED,
+  LOAD_BALANCER_POLICY_CONSISTENT_HASH,
+};
+
 struct load_balancer
 {
-  queue_t *inbound_queue;
-  queue_t *outbound_queue;
+  retry_t *retry;
   uint64_t *distribution;
+  uint64_t *weights;
   size_t cap;
   uint64_t i;
+  uint64_t sequence;
+  const strategy_t *strategy;
+  void *state;
+  hash_ring_t *ring;
+  atomic_uint_fast64_t *moved_in;
+  atomic_uint_fast64_t *moved_out;
+  uint64_t reserved;
 };
 
 typedef struct load_balancer load_balancer_t;
 
-load_balancer_t *load_balancer_new(const size_t max_queue, const size_t cap);
+/**
+ * @note The policy selects one of the built-in strategies. Every channel
+ *       starts with a weight of one.
+ */
+load_balancer_t *load_balancer_new(scheduler_t *scheduler, const size_t cap, const int policy);
 
 void load_balancer_destroy(load_balancer_t *self);
 
-void load_balancer_wait(load_balancer_t *self, void *observable, scheduler_t *scheduler);
+/**
+ * @brief Replace the strategy, its state is created against the current
+ *        distribution and the previous state is destroyed.
+ */
+void load_balancer_set_strategy(load_balancer_t *self, const strategy_t *strategy);
+
+bool load_balancer_set_weight(load_balancer_t *self, const uint64_t k, const uint64_t weight);
+
+/**
+ * @brief Place channel k on the key ring used by keyed publishes.
+ */
+bool load_balancer_join(load_balancer_t *self, const uint64_t k);
+
+/**
+ * @brief Record that n items were taken from channel from and will be
+ *        acknowledged by channel to. Safe to call from any thread, the
+ *        publisher folds the counts into the distribution.
+ */
+void load_balancer_moved(load_balancer_t *self, const uint64_t from, const uint64_t to, const uint64_t n);
+
+/**
+ * @brief Block until every failed write and read was retried, taking the
+ *        acks of the observers in the meantime.
+ */
+void load_balancer_wait(load_balancer_t *self, void *observable);
 
 bool load_balancer_publish(load_balancer_t *self, void *observable, scheduler_t *scheduler,
   bidirectional_channel_t **channels, const void *data);
 
+/**
+ * @note Returns only once the item sits in its channel, so items sharing
+ *       a key are never reordered by the retry queue.
+ */
+bool load_balancer_publish_keyed(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const uint64_t key, const void *data);
+
+/**
+ * @brief Push an item into the priority band of the channel picked by the
+ *        strategy. Returns false when the channels have no bands.
+ */
+bool load_balancer_publish_priority(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const uint32_t prio, const void *data);
+
+bool load_balancer_publish_record(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const void *data, const size_t len);
+
+/**
+ * @brief Reserve len bytes in the record ring of the next channel. The
+ *        channel is remembered until load_balancer_commit.
+ */
+void *load_balancer_reserve(load_balancer_t *self, bidirectional_channel_t **channels, const size_t len);
+
+/**
+ * @note Returns false when there is no reservation to commit or len is
+ *       larger than it.
+ */
+bool load_balancer_commit(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const size_t len);
+
+bool load_balancer_publish_many(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const void **items, const size_t n);
+
 #endif/*HYPER_FUNNEL__LOAD_BALANCER_H*/
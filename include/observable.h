@@ -12,6 +12,19 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+enum
+{
+  OBSERVABLE_FLAG_NONE        = 0,
+  OBSERVABLE_FLAG_LOCK_FREE   = 1 << 0,
+  OBSERVABLE_FLAG_SHARDED     = 1 << 1,
+  OBSERVABLE_FLAG_TWO_CHOICES = 1 << 2,
+  OBSERVABLE_FLAG_NO_STEAL    = 1 << 3,
+  OBSERVABLE_FLAG_RECORDS     = 1 << 4,
+  OBSERVABLE_FLAG_SPSC        = 1 << 5,
+  OBSERVABLE_FLAG_PRIORITY    = 1 << 6,
+  OBSERVABLE_FLAG_EVENTFD     = 1 << 7,
+};
+
 struct observable
 {
   bipartite_queue_t *queue;
@@ -24,22 +37,95 @@ struct observable
   size_t max_threads;
   atomic_bool done;
   scheduler_t *scheduler;
+  bool steal;
 };
 
 typedef struct observable observable_t;
 
-observable_t *observable_new(const size_t cap, const size_t max_observers, const size_t max_threads);
+observable_t *observable_new(const size_t cap, const size_t max_observers, const size_t max_threads, const int flags);
 
 void observable_destroy(observable_t *self);
 
 void observable_select(observable_t *self, observer_t *observer);
 
-void observable_shutdown(observable_t *self);
+/**
+ * @brief Wait for the observers to drain their downstream channels, then
+ *        stop them. A negative timeout waits forever. Returns the number
+ *        of items that were still queued when the wait ended.
+ */
+uint64_t observable_shutdown(observable_t *self, const long timeout_ms);
 
 bool observable_cleanup(observable_t *self);
 
+/**
+ * @brief Publish an item to the channel picked by the strategy.
+ *
+ * @note  Who frees the item depends on the channels. With
+ *        OBSERVABLE_FLAG_SPSC the observer receives data itself and frees
+ *        it, so the publisher must not touch it again. In every other mode
+ *        the scheduler copies sizeof(int) bytes of data into the channel
+ *        and the observer receives and frees that heap copy. data then
+ *        stays with the publisher, which must keep it valid until
+ *        observable_cleanup returns, since a rejected write is retried
+ *        from it, and frees it afterwards. The keyed, priority and batch
+ *        variants hand items over the same way.
+ */
 bool observable_publish(observable_t *self, const void *data);
 
+/**
+ * @brief Publish an item to the channel that owns key on a consistent-hash
+ *        ring of the subscribed observers. Items with the same key reach
+ *        the same observer in publish order, and subscribing another
+ *        observer only moves about 1/n of the keys.
+ *
+ * @note  An idle sibling steals from the head of a channel, so two items
+ *        of one key may then run at the same time on two observers. Create
+ *        the observable with OBSERVABLE_FLAG_NO_STEAL when the handlers
+ *        rely on per-key order; a busy channel then drains only at the
+ *        pace of its own observer.
+ */
+bool observable_publish_keyed(observable_t *self, const uint64_t key, const void *data);
+
+/**
+ * @brief Publish an item that overtakes regular traffic. Each channel has
+ *        CHANNEL_PRIORITY_BANDS lock-free bands and observers drain the
+ *        highest band first, then the lower ones, then the regular queue;
+ *        prio values past the last band share it. Needs
+ *        OBSERVABLE_FLAG_PRIORITY, which in turn needs OBSERVABLE_FLAG_SPSC
+ *        so that every item reaches the observer as the pointer that was
+ *        published.
+ */
+bool observable_publish_priority(observable_t *self, const uint32_t prio, const void *data);
+
+/**
+ * @brief Copy a record of len bytes inline into the record ring of a
+ *        channel, no allocation involved. Needs OBSERVABLE_FLAG_RECORDS.
+ *        Returns false when every channel is full.
+ */
+bool observable_publish_record(observable_t *self, const void *data, const size_t len);
+
+/**
+ * @brief Zero-copy variant of observable_publish_record. Returns room for
+ *        len bytes inside the record ring of a channel, or NULL when every
+ *        channel is full; the caller writes the payload in place and
+ *        hands it to the observer with observable_commit.
+ */
+void *observable_reserve(observable_t *self, const size_t len);
+
+/**
+ * @note len may be smaller than the reservation. Returns false when there
+ *       is no reservation to commit or len is larger than it, the
+ *       reservation is then kept.
+ */
+bool observable_commit(observable_t *self, const size_t len);
+
+/**
+ * @brief Publish n items at once. Destinations are chosen once for the
+ *        whole batch and each channel receives one contiguous run under
+ *        a single scheduler acquisition.
+ */
+bool observable_publish_many(observable_t *self, const void **items, const size_t n);
+
 bool observable_subscribe(observable_t *self, observer_t *observer);
 
 #endif/*HYPER_FUNNEL__OBSERVABLE_H*/
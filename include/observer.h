@@ -5,10 +5,31 @@
 
 #include <stdatomic.h>
 
+/**
+ * @brief The ready word doubles as a futex. OBSERVER_STATE_PARKED marks
+ *        an idle observer with a thread asleep on it, so a release only
+ *        pays for a wake-up system call when somebody is waiting.
+ */
+enum
+{
+  OBSERVER_STATE_IDLE,
+  OBSERVER_STATE_READY,
+  OBSERVER_STATE_PARKED,
+};
+
+#define OBSERVER_RUN_BATCH 64
+
 struct observer;
 
 typedef void *(*observer_callback_t)(void *);
 
+/**
+ * @brief Handles a batch of n items received by observer_run. The items
+ *        belong to the handler, observer_run acknowledges them once it
+ *        returns.
+ */
+typedef void (*observer_handler_t)(struct observer *observer, void **items, const size_t n);
+
 struct observable;
 
 struct observer
@@ -17,7 +38,8 @@ struct observer
   struct observable *observable;
   bidirectional_channel_t *channel;
   observer_callback_t notify;
-  atomic_bool ready;
+  atomic_uint ready;
+  int unacked;
 };
 
 typedef struct observer observer_t;
@@ -26,8 +48,95 @@ observer_t *observer_new(struct observable *observable, bidirectional_channel_t
 
 void observer_destroy(observer_t *self);
 
+/**
+ * @note Only the first release after observer_clear signals the eventfd of
+ *       the channel, so a burst of publishes costs one write.
+ */
 void observer_release(observer_t *self);
 
 void observer_clear(observer_t *self);
 
+/**
+ * @brief The eventfd of the channel of the observer, or -1 when it has
+ *        none. It turns readable once an empty observer gets items.
+ */
+int observer_fd(observer_t *self);
+
+/**
+ * @brief Call when the eventfd turned readable, before draining the
+ *        channel: it resets the eventfd and the ready word, so items
+ *        published while draining signal again.
+ *
+ * @note  The eventfd is read before the ready word is cleared. The other
+ *        way round, a publish in between would have its signal consumed
+ *        here while the word stays ready, and no later publish would
+ *        signal again.
+ */
+void observer_rearm(observer_t *self);
+
+/**
+ * @brief Drain up to max items from the downstream channel of the
+ *        observer in one scheduler round-trip. Items in the priority
+ *        bands, highest first, come before regular ones. Returns the
+ *        number of items stored in out, each of which the caller must
+ *        free. With SPSC channels those are the published pointers,
+ *        otherwise copies made by the scheduler.
+ *
+ * @note  failure is set like scheduler_dequeue_many sets it. A return of 0
+ *        with SCHEDULER_FAILURE_SAVE means the scheduler was busy, not
+ *        that the channel is empty.
+ */
+size_t observer_receive_batch(observer_t *self, void **out, const size_t max, int *failure);
+
+/**
+ * @brief Report n processed items on the upstream channel so the load
+ *        balancer can lower the count of this observer. Returns false
+ *        when the upstream channel is busy or full; retry later.
+ */
+bool observer_ack(observer_t *self, const int n);
+
+/**
+ * @brief Copy the oldest inline record of the downstream channel into out.
+ *        On entry *len holds the size of out, on return the length of the
+ *        record. Returns false when there is none or out is too small.
+ *
+ * @note  The record functions acknowledge every record themselves, so
+ *        record consumers never call observer_ack. An ack the upstream
+ *        side cannot take yet goes out with a later call, including one
+ *        that finds the ring empty.
+ */
+bool observer_receive_record(observer_t *self, void *out, size_t *len);
+
+/**
+ * @brief Oldest inline record of the downstream channel, read in place
+ *        without a copy. It stays valid until observer_release_record.
+ *        Returns NULL when there is none.
+ */
+const void *observer_peek_record(observer_t *self, size_t *len);
+
+/**
+ * @brief Give the peeked record back to the ring and acknowledge it.
+ */
+void observer_release_record(observer_t *self);
+
+/**
+ * @brief Take up to max items, but no more than half, from the sibling
+ *        with the deepest downstream channel. Meant for an observer that
+ *        found its own channel empty. The caller acknowledges the items
+ *        on its own upstream channel as usual.
+ *
+ * @note  Always 0 for SPSC channels, which allow only one reader, and with
+ *        OBSERVABLE_FLAG_NO_STEAL, which keeps keyed items in order.
+ */
+size_t observer_steal(observer_t *self, void **out, const size_t max);
+
+/**
+ * @brief Receive, handle and acknowledge batches until the observable shuts
+ *        down. When neither its own channel nor a sibling has anything the
+ *        observer parks on its ready word, and the next publish to its
+ *        channel or the shutdown wakes it. A busy scheduler is retried,
+ *        never mistaken for an empty channel.
+ */
+void observer_run(observer_t *self, observer_handler_t handler);
+
 #endif/*HYPER_FUNNEL__OBSERVER_H*/
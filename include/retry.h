@@ -0,0 +1,96 @@
+#ifndef HYPER_FUNNEL__RETRY_H
+#define HYPER_FUNNEL__RETRY_H
+
+#include "ring.h"
+#include "scheduler.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define RETRY_RING_CAPACITY    4096
+#define RETRY_BATCH            64
+
+#define RETRY_BACKOFF_MIN_NS   1000L
+#define RETRY_BACKOFF_MAX_NS   1000000L
+
+enum
+{
+  RETRY_TYPE_WRITE,
+  RETRY_TYPE_READ,
+};
+
+/**
+ * @brief A failed scheduler_enqueue or scheduler_dequeue, stored by value
+ *        in the ring. state is the SCHEDULER_STATE_* to resume from.
+ */
+struct retry_record
+{
+  uint64_t channel_id;
+  const void *data;
+  int64_t not_before;
+  uint32_t attempts;
+  int type;
+  int state;
+};
+
+typedef struct retry_record retry_record_t;
+
+HF_DEFINE_RING(retry_ring, retry_record_t, RETRY_RING_CAPACITY)
+
+/**
+ * @brief Called once a record went through. failure is the
+ *        SCHEDULER_FAILURE_NODEFECT or SCHEDULER_FAILURE_SUCCESSFUL of the
+ *        last attempt and result what scheduler_dequeue returned for reads.
+ */
+typedef void (*retry_callback_t)(const retry_record_t *record, const int failure,
+  void *result, void *args);
+
+/**
+ * @note A retry engine belongs to a single thread. Records wait with an
+ *       exponential, jittered backoff between attempts and runs of writes
+ *       to the same channel go back to the scheduler as one batch.
+ */
+struct retry
+{
+  scheduler_t *scheduler;
+  retry_callback_t callback;
+  uint64_t seed;
+  retry_ring_t ring;
+};
+
+typedef struct retry retry_t;
+
+retry_t *retry_new(scheduler_t *scheduler, retry_callback_t callback);
+
+void retry_destroy(retry_t *self);
+
+/**
+ * @brief Record the outcome of a scheduler_enqueue (RETRY_TYPE_WRITE) or
+ *        scheduler_dequeue (RETRY_TYPE_READ) on channel_id. Only the
+ *        save, execute, early release and rejected failures are kept, the
+ *        first retry goes out on the next flush. Returns false when there
+ *        is nothing to retry or the ring is full.
+ *
+ * @note  For SCHEDULER_FAILURE_REJECTED pass the channel and payload handed
+ *        back by the scheduler, they are saved again.
+ */
+bool retry_submit(retry_t *self, const int failure, const int type,
+  const uint64_t channel_id, const void *data);
+
+/**
+ * @brief Resubmit every record whose backoff expired, without blocking.
+ *        Records that fail again go back to the ring. Returns the number
+ *        of records that went through.
+ */
+size_t retry_flush(retry_t *self, void *args);
+
+/**
+ * @brief Flush until the ring is empty, yielding the processor while
+ *        every remaining record is still backing off.
+ */
+void retry_drain(retry_t *self, void *args);
+
+bool retry_empty(retry_t *self);
+
+#endif/*HYPER_FUNNEL__RETRY_H*/
@@ -0,0 +1,182 @@
+#ifndef HYPER_FUNNEL__RING_H
+#define HYPER_FUNNEL__RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HF_RING_CACHE_LINE 64
+
+/**
+ * @brief Cursors of a single-producer/single-consumer ring of cap slots,
+ *        for rings whose capacity is only known at run time. Each side
+ *        owns its cursor on its own cache line, publishes it with a
+ *        release store and keeps a cached copy of the opposite cursor,
+ *        which it only reloads with an acquire load when the ring looks
+ *        full or empty. A zeroed hf_ring_cursors_t is an empty ring.
+ *
+ * @note  The cursors count slots and never wrap back to zero, so the
+ *        capacity must be a power of two. HF_DEFINE_RING builds on the
+ *        same functions with a constant capacity.
+ */
+struct hf_ring_cursors
+{
+  atomic_size_t w;
+  size_t cached_r;
+  char pad0[HF_RING_CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+  atomic_size_t r;
+  size_t cached_w;
+  char pad1[HF_RING_CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
+
+typedef struct hf_ring_cursors hf_ring_cursors_t;
+
+static inline void hf_ring_cursors_init(hf_ring_cursors_t *self)
+{
+  atomic_init(&self->w, 0UL);
+  atomic_init(&self->r, 0UL);
+  self->cached_r = 0UL;
+  self->cached_w = 0UL;
+}
+
+/**
+ * @brief Free slots ahead of the write cursor w, reloading the read cursor
+ *        only when fewer than n look free.
+ */
+static inline size_t hf_ring_room(hf_ring_cursors_t *self, const size_t cap, const size_t w, const size_t n)
+{
+  if (cap - (w - self->cached_r) < n)
+  {
+    self->cached_r = atomic_load_explicit(&self->r, memory_order_acquire);
+  }
+
+  return cap - (w - self->cached_r);
+}
+
+/**
+ * @brief Filled slots ahead of the read cursor r, reloading the write
+ *        cursor only when fewer than n look filled.
+ */
+static inline size_t hf_ring_ready(hf_ring_cursors_t *self, const size_t r, const size_t n)
+{
+  if ((self->cached_w - r) < n)
+  {
+    self->cached_w = atomic_load_explicit(&self->w, memory_order_acquire);
+  }
+
+  return self->cached_w - r;
+}
+
+static inline size_t hf_ring_size(hf_ring_cursors_t *self)
+{
+  const size_t r = atomic_load_explicit(&self->r, memory_order_acquire);
+  const size_t w = atomic_load_explicit(&self->w, memory_order_acquire);
+
+  return w - r;
+}
+
+/**
+ * @brief Generate a statically typed single-producer/single-consumer ring
+ *        of CAP_POW2 elements of type T, named name_t, together with
+ *        static inline name_push/pop/push_many/pop_many/size/empty.
+ *
+ * @note  The capacity is a compile-time power of two, so every index is a
+ *        constant mask and the whole hot path inlines into the caller.
+ *        The cursors live on their own cache lines and each side keeps a
+ *        cached copy of the opposite cursor, reloading it only when the
+ *        ring looks full or empty. A zeroed name_t is an empty ring.
+ */
+#define HF_DEFINE_RING(name, T, CAP_POW2)                                        \
+                                                                                 \
+_Static_assert((CAP_POW2) > 1 && 0 == ((CAP_POW2) & ((CAP_POW2) - 1)),           \
+  #name " capacity must be a power of two");                                     \
+                                                                                 \
+struct name                                                                      \
+{                                                                                \
+  hf_ring_cursors_t cursors;                                                     \
+  T items[(CAP_POW2)];                                                           \
+};                                                                               \
+                                                                                 \
+typedef struct name name##_t;                                                    \
+                                                                                 \
+static inline void name##_init(name##_t *self)                                   \
+{                                                                                \
+  hf_ring_cursors_init(&self->cursors);                                          \
+}                                                                                \
+                                                                                 \
+static inline bool name##_push(name##_t *self, const T item)                     \
+{                                                                                \
+  const size_t w = atomic_load_explicit(&self->cursors.w, memory_order_relaxed); \
+                                                                                 \
+  if (0UL == hf_ring_room(&self->cursors, (CAP_POW2), w, 1UL))                   \
+  {                                                                              \
+    return false;                                                                \
+  }                                                                              \
+                                                                                 \
+  self->items[w & ((CAP_POW2) - 1)] = item;                                      \
+  atomic_store_explicit(&self->cursors.w, w + 1UL, memory_order_release);        \
+                                                                                 \
+  return true;                                                                   \
+}                                                                                \
+                                                                                 \
+static inline bool name##_pop(name##_t *self, T *out)                            \
+{                                                                                \
+  const size_t r = atomic_load_explicit(&self->cursors.r, memory_order_relaxed); \
+                                                                                 \
+  if (0UL == hf_ring_ready(&self->cursors, r, 1UL))                              \
+  {                                                                              \
+    return false;                                                                \
+  }                                                                              \
+                                                                                 \
+  *out = self->items[r & ((CAP_POW2) - 1)];                                      \
+  atomic_store_explicit(&self->cursors.r, r + 1UL, memory_order_release);        \
+                                                                                 \
+  return true;                                                                   \
+}                                                                                \
+                                                                                 \
+static inline size_t name##_push_many(name##_t *self, const T *items, size_t n)  \
+{                                                                                \
+  const size_t w = atomic_load_explicit(&self->cursors.w, memory_order_relaxed); \
+  const size_t room = hf_ring_room(&self->cursors, (CAP_POW2), w, n);            \
+  const size_t at = w & ((CAP_POW2) - 1);                                        \
+  size_t head;                                                                   \
+                                                                                 \
+  n = (n < room) ? n : room;                                                     \
+  head = ((CAP_POW2) - at < n) ? ((CAP_POW2) - at) : n;                          \
+                                                                                 \
+  memcpy(&self->items[at], items, head * sizeof(T));                             \
+  memcpy(&self->items[0], &items[head], (n - head) * sizeof(T));                 \
+  atomic_store_explicit(&self->cursors.w, w + n, memory_order_release);          \
+                                                                                 \
+  return n;                                                                      \
+}                                                                                \
+                                                                                 \
+static inline size_t name##_pop_many(name##_t *self, T *out, size_t n)           \
+{                                                                                \
+  const size_t r = atomic_load_explicit(&self->cursors.r, memory_order_relaxed); \
+  const size_t ready = hf_ring_ready(&self->cursors, r, n);                      \
+  const size_t at = r & ((CAP_POW2) - 1);                                        \
+  size_t head;                                                                   \
+                                                                                 \
+  n = (n < ready) ? n : ready;                                                   \
+  head = ((CAP_POW2) - at < n) ? ((CAP_POW2) - at) : n;                          \
+                                                                                 \
+  memcpy(out, &self->items[at], head * sizeof(T));                               \
+  memcpy(&out[head], &self->items[0], (n - head) * sizeof(T));                   \
+  atomic_store_explicit(&self->cursors.r, r + n, memory_order_release);          \
+                                                                                 \
+  return n;                                                                      \
+}                                                                                \
+                                                                                 \
+static inline size_t name##_size(name##_t *self)                                 \
+{                                                                                \
+  return hf_ring_size(&self->cursors);                                           \
+}                                                                                \
+                                                                                 \
+static inline bool name##_empty(name##_t *self)                                  \
+{                                                                                \
+  return 0UL == name##_size(self);                                               \
+}
+
+#endif/*HYPER_FUNNEL__RING_H*/
@@ -1,12 +1,54 @@
 #ifndef HYPER_FUNNEL__SCHEDULER_H
 #define HYPER_FUNNEL__SCHEDULER_H
 
+#include "internal/mpmc_ring.h"
+
 #include <turnpike/bipartite.h>
 
 #include <inttypes.h>
 #include <semaphore.h>
+#include <stdatomic.h>
 #include <stddef.h>
 
+/**
+ * @brief SCHEDULER_MODE_LOCKED serializes every schedule and execute
+ *        on one semaphore. SCHEDULER_MODE_LOCK_FREE keeps the command
+ *        queues in lock-free rings and only serializes the execution
+ *        of commands against the same target. SCHEDULER_MODE_SHARDED
+ *        additionally gives every target its own pair of rings, so
+ *        traffic on one channel never queues behind another.
+ *
+ * @note  The modes only differ in how commands are queued. In all of them
+ *        the targets are turnpike bipartite queues, which copy an item in
+ *        on write and hand out a heap copy on read that the reader frees.
+ *        Only the SPSC channels, which bypass the scheduler, move items
+ *        without allocating.
+ */
+enum
+{
+  SCHEDULER_MODE_LOCKED,
+  SCHEDULER_MODE_LOCK_FREE,
+  SCHEDULER_MODE_SHARDED,
+};
+
+/**
+ * @note In lock-free mode every shard aliases the rings of shard zero
+ *       and only the busy flag is per target. The locked mode has no
+ *       rings and only uses the shard to track the depth of the target.
+ */
+struct scheduler_shard
+{
+  mpmc_ring_t *inbound;
+  mpmc_ring_t *outbound;
+  atomic_uint_fast64_t depth;
+  atomic_flag busy;
+  char pad[MPMC_RING_CACHE_LINE];
+};
+
+typedef struct scheduler_shard scheduler_shard_t;
+
+struct command_pool;
+
 enum
 {
   SCHEDULER_STATE_SAVE,
@@ -20,29 +62,57 @@ enum
   SCHEDULER_FAILURE_EXECUTE,
   SCHEDULER_FAILURE_NODEFECT,
   SCHEDULER_FAILURE_EARLY_RELEASE,
+  SCHEDULER_FAILURE_REJECTED,
 };
 
+/**
+ * @brief A write the scheduler took off its command queue but could not
+ *        deliver because the target was full. The payload was not touched
+ *        and belongs to the caller again, who has to save it once more.
+ *
+ * @note  With several targets sharing a command queue the rejected write
+ *        need not be the one the caller just saved.
+ */
+struct scheduler_rejected
+{
+  uint64_t channel_id;
+  const void *data;
+};
+
+typedef struct scheduler_rejected scheduler_rejected_t;
+
+/**
+ * @note In locked mode the holder of the semaphore may run w_budget writes
+ *       or r_budget reads in a row before it is checked for an early
+ *       release. waiters counts the acquisitions that failed in the
+ *       meantime; the budgets are only touched under the semaphore.
+ */
 struct scheduler
 {
+  int mode;
   bipartite_queue_t *inbound;
   bipartite_queue_t *outbound;
+  scheduler_shard_t *shards;
+  struct command_pool *pool;
   bipartite_queue_t **targets;
   size_t max_targets;
   sem_t lock;
   uint64_t target_count;
-  uint64_t counter;
+  atomic_uint_fast64_t counter;
+  atomic_uint drained;
+  atomic_uint drain_waiters;
   size_t max_jobs;
-  size_t mcop;
-  uint64_t w_sched;
-  uint64_t w_exec;
-  uint64_t r_sched;
-  uint64_t r_exec;
+  atomic_uint_fast64_t waiters;
+  uint64_t w_burst;
+  uint64_t w_budget;
+  uint64_t r_burst;
+  uint64_t r_budget;
 };
 
 typedef struct scheduler scheduler_t;
 
 scheduler_t *scheduler_new(const size_t max_targets, const size_t max_jobs,
-  const size_t max_data, bipartite_queue_t *target);
+  const size_t max_data, bipartite_queue_t *target, const int mode);
 
 void scheduler_destroy(scheduler_t *self);
 
@@ -50,10 +120,43 @@ void scheduler_add(scheduler_t *self, bipartite_queue_t *target);
 
 bipartite_queue_t *scheduler_get(scheduler_t *self, const uint64_t i);
 
-bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const int state, const void *data);
+/**
+ * @note On SCHEDULER_FAILURE_REJECTED the write that did not fit is handed
+ *       back through rejected.
+ */
+bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const int state, const void *data,
+  scheduler_rejected_t *rejected);
 
 void *scheduler_dequeue(scheduler_t *self, const uint64_t i, int *failure, const int state);
 
+/**
+ * @brief Write a run of items into target i under a single acquisition
+ *        of the scheduler, bypassing the command queues. Returns the
+ *        number of leading items written; the rest should be retried.
+ *        Nothing written because the target is full is reported as
+ *        SCHEDULER_FAILURE_REJECTED.
+ */
+size_t scheduler_enqueue_many(scheduler_t *self, const uint64_t i, int *failure, const void **data, const size_t n);
+
+/**
+ * @brief Drain up to max items out of target i under a single acquisition
+ *        of the scheduler. Returns the number of items stored in out.
+ */
+size_t scheduler_dequeue_many(scheduler_t *self, const uint64_t i, int *failure, void **out, const size_t max);
+
 bool scheduler_empty(scheduler_t *self, const int i);
 
+/**
+ * @brief Number of items currently held by target i, maintained by the
+ *        scheduler as commands execute. No lock is taken.
+ */
+uint64_t scheduler_depth(scheduler_t *self, const uint64_t i);
+
+/**
+ * @brief Block until the targets [0, n) hold no items or the timeout
+ *        expires. A negative timeout waits forever. Returns the number
+ *        of items still held by those targets.
+ */
+uint64_t scheduler_drain(scheduler_t *self, const uint64_t n, const long timeout_ms);
+
 #endif/*HYPER_FUNNEL__SCHEDULER_H*/
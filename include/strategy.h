@@ -0,0 +1,64 @@
+#ifndef HYPER_FUNNEL__STRATEGY_H
+#define HYPER_FUNNEL__STRATEGY_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+struct load_balancer;
+
+/**
+ * @brief Channel selection policy of a load balancer. select() picks the
+ *        channel for the next item, given its key: the caller's key for a
+ *        keyed publish, the publish sequence number otherwise.
+ *        on_delivered() and on_acked() are called after the distribution
+ *        of channel k went up or down by n. State returned by create() is
+ *        handed back to every call.
+ *
+ * @note  plan() is optional. When it is set a batch of n items is split
+ *        at once into quota[k]; otherwise select() is called per item.
+ */
+struct strategy
+{
+  void *(*create)(const struct load_balancer *lb);
+  void (*destroy)(void *state);
+  uint64_t (*select)(const struct load_balancer *lb, void *state, const uint64_t key);
+  void (*on_delivered)(const struct load_balancer *lb, void *state, const uint64_t k, const uint64_t n);
+  void (*on_acked)(const struct load_balancer *lb, void *state, const uint64_t k, const uint64_t n);
+  void (*plan)(const struct load_balancer *lb, void *state, size_t *quota, const size_t n);
+};
+
+typedef struct strategy strategy_t;
+
+/**
+ * @brief Cycle through the channels in order.
+ */
+extern const strategy_t strategy_round_robin;
+
+/**
+ * @brief Channel with the fewest outstanding items, kept in an indexed
+ *        min-heap.
+ */
+extern const strategy_t strategy_least_loaded;
+
+/**
+ * @brief Less loaded of two randomly sampled channels.
+ */
+extern const strategy_t strategy_two_choices;
+
+/**
+ * @brief Smooth weighted round-robin over the load balancer weights.
+ */
+extern const strategy_t strategy_weighted;
+
+/**
+ * @brief Owner of the key on the consistent-hash ring of the channels that
+ *        joined the load balancer. A key sticks to one channel, and a new
+ *        member only takes over about 1/n of the keys.
+ *
+ * @note  Keyed publishes always go through this strategy, whatever the
+ *        policy. As the policy it also spreads unkeyed items, whose key is
+ *        their sequence number.
+ */
+extern const strategy_t strategy_consistent_hash;
+
+#endif/*HYPER_FUNNEL__STRATEGY_H*/
@@ -7,79 +7,100 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void heapify_down(priority_queue_t *self);
+static void heapify_down(priority_queue_t *self, size_t index);
 
-static void heapify_up(priority_queue_t *self);
+static void heapify_up(priority_queue_t *self, size_t index);
 
-priority_queue_t *priority_queue_new(void)
+static void priority_queue_reserve(priority_queue_t *self, const size_t cap)
 {
-  priority_queue_t *self = NULL;
-  self = (priority_queue_t *)calloc(1, sizeof(*self));
-  return self;
-}
+  uint64_t *keys = NULL;
+  void **handles = NULL;
 
-void priority_queue_destroy(priority_queue_t *self)
-{
-  if (self != NULL)
+  const size_t slots = PQ_ROOT + cap;
+  const size_t bytes = slots * sizeof(*keys);
+
+  keys = (uint64_t *)aligned_alloc(PQ_CACHE_LINE, (bytes + PQ_CACHE_LINE - 1) & ~(size_t)(PQ_CACHE_LINE - 1));
+  if (keys == NULL)
   {
-    free(self);
-    self = NULL;
+    perror("priority queue memory error");
+    exit(EXIT_FAILURE);
   }
-}
 
-static uint64_t get_left_child_index(const uint64_t parent_index)
-{
-  return 2 * parent_index + 1;
-}
+  if (self->keys != NULL)
+  {
+    memcpy(keys, self->keys, (PQ_ROOT + self->size) * sizeof(*keys));
+    free(self->keys);
+  }
+  self->keys = keys;
 
-static uint64_t get_right_child_index(const uint64_t parent_index)
-{
-  return 2 * parent_index + 2;
-}
+  handles = (void **)realloc(self->handles, slots * sizeof(*handles));
+  if (handles == NULL)
+  {
+    perror("priority queue memory error");
+    exit(EXIT_FAILURE);
+  }
+  self->handles = handles;
 
-static uint64_t get_parent_index(const uint64_t child_index)
-{
-  return (child_index - 1) / 2;
+  self->cap = cap;
 }
 
-static uint64_t get_left_child(priority_queue_t *self, const uint64_t parent_index)
+priority_queue_t *priority_queue_new(const size_t cap)
 {
-  return self->values[get_left_child_index(parent_index)].key;
-}
+  priority_queue_t *self = NULL;
+  self = (priority_queue_t *)calloc(1, sizeof(*self));
+  if (self == NULL)
+  {
+    perror("priority queue memory error");
+    exit(EXIT_FAILURE);
+  }
 
-static uint64_t get_right_child(priority_queue_t *self, const uint64_t parent_index)
-{
-  return self->values[get_right_child_index(parent_index)].key;
-}
+  priority_queue_reserve(self, (cap < PQ_MIN_CAPACITY) ? PQ_MIN_CAPACITY : cap);
 
-static uint64_t get_parent(priority_queue_t *self, const uint64_t child_index)
-{
-  return self->values[get_parent_index(child_index)].key;
+  return self;
 }
 
-static bool has_left_child(priority_queue_t *self, const uint64_t parent_index)
+void priority_queue_destroy(priority_queue_t *self)
 {
-  return get_left_child_index(parent_index) < self->size;
+  if (self != NULL)
+  {
+    free(self->keys);
+    free(self->handles);
+    free(self);
+    self = NULL;
+  }
 }
 
-static bool has_right_child(priority_queue_t *self, const uint64_t parent_index)
+/**
+ * @note With the root at PQ_ROOT, slot p maps to heap node p - PQ_ROOT, whose
+ *       children are slots PQ_ARITY * (p - PQ_ROOT + 1) onwards.
+ */
+static size_t get_first_child_index(const size_t parent_index)
 {
-  return get_right_child_index(parent_index) < self->size;
+  return PQ_ARITY * (parent_index - PQ_ROOT + 1);
 }
 
-static bool has_parent(priority_queue_t *self, const uint64_t child_index)
+static size_t get_parent_index(const size_t child_index)
 {
-  return get_parent_index(child_index) >= 0;
+  return child_index / PQ_ARITY + PQ_ROOT - 1;
 }
 
-static void swap(priority_queue_t *self, const uint64_t i, const uint64_t j)
+void *priority_queue_peek(priority_queue_t *self)
 {
-  priority_queue_node_t temp = self->values[i];
-  self->values[i] = self->values[j];
-  self->values[j] = temp;
+  if (self == NULL)
+  {
+    perror("priority queue pointer is null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->size == 0)
+  {
+    return NULL;
+  }
+
+  return self->handles[PQ_ROOT];
 }
 
-void *priority_queue_peek(priority_queue_t *self)
+bool priority_queue_peek_key(priority_queue_t *self, uint64_t *key)
 {
   if (self == NULL)
   {
@@ -89,13 +110,11 @@ void *priority_queue_peek(priority_queue_t *self)
 
   if (self->size == 0)
   {
-    return NULL;
+    return false;
   }
 
-  void *data = NULL;
-  data = calloc(PQ_NODE_SIZE, sizeof(uint8_t));
-  memcpy(data, self->values[0].data, PQ_NODE_SIZE * sizeof(uint8_t));
-  return data;
+  *key = self->keys[PQ_ROOT];
+  return true;
 }
 
 void *priority_queue_poll(priority_queue_t *self)
@@ -111,19 +130,21 @@ void *priority_queue_poll(priority_queue_t *self)
     return NULL;
   }
 
-  void *data = NULL;
-  data = calloc(PQ_NODE_SIZE, sizeof(uint8_t));
-  memcpy(data, self->values[0].data, PQ_NODE_SIZE * sizeof(uint8_t));
+  void *data = self->handles[PQ_ROOT];
 
-  memcpy(&self->values[0], &self->values[self->size - 1], PQ_NODE_SIZE * sizeof(uint8_t));
   self->size--;
 
-  heapify_down(self);
+  if (self->size > 0)
+  {
+    self->keys[PQ_ROOT] = self->keys[PQ_ROOT + self->size];
+    self->handles[PQ_ROOT] = self->handles[PQ_ROOT + self->size];
+    heapify_down(self, PQ_ROOT);
+  }
 
   return data;
 }
 
-void priority_queue_add(priority_queue_t *self, const uint64_t key, const void *data, const size_t size)
+void priority_queue_add(priority_queue_t *self, const uint64_t key, const void *data)
 {
   if (self == NULL)
   {
@@ -131,18 +152,19 @@ void priority_queue_add(priority_queue_t *self, const uint64_t key, const void *
     exit(EXIT_FAILURE);
   }
 
-  if (self->size >= 10)
+  if (self->size == self->cap)
   {
-    return;
+    priority_queue_reserve(self, self->cap * 2);
   }
 
-  self->values[self->size].key = key;
-  memcpy(self->values[self->size].data, data, size * sizeof(uint8_t));
+  self->keys[PQ_ROOT + self->size] = key;
+  self->handles[PQ_ROOT + self->size] = (void *)data;
   self->size++;
-  heapify_up(self);
+
+  heapify_up(self, PQ_ROOT + self->size - 1);
 }
 
-static void heapify_down(priority_queue_t *self)
+size_t priority_queue_size(priority_queue_t *self)
 {
   if (self == NULL)
   {
@@ -150,43 +172,62 @@ static void heapify_down(priority_queue_t *self)
     exit(EXIT_FAILURE);
   }
 
-  uint64_t index = 0;
+  return self->size;
+}
 
-  while (has_left_child(self, index))
+static void heapify_down(priority_queue_t *self, size_t index)
+{
+  const uint64_t key = self->keys[index];
+  void *handle = self->handles[index];
+
+  const size_t end = PQ_ROOT + self->size;
+
+  size_t first;
+  size_t last;
+  size_t smallest;
+  size_t j;
+
+  while ((first = get_first_child_index(index)) < end)
   {
-    uint64_t smaller_child_index = get_left_child_index(index);
+    last = (first + PQ_ARITY < end) ? first + PQ_ARITY : end;
+    smallest = first;
 
-    if (has_right_child(self, index) && get_right_child(self, index) < get_left_child(self, index))
+    for (j = first + 1; j < last; j++)
     {
-      smaller_child_index = get_right_child_index(index);
+      if (self->keys[j] < self->keys[smallest])
+      {
+        smallest = j;
+      }
     }
 
-    if (self->values[index].key < self->values[smaller_child_index].key)
+    if (key <= self->keys[smallest])
     {
       break;
     }
-    else
-    {
-      swap(self, index, smaller_child_index);
-    }
 
-    index = smaller_child_index;
+    self->keys[index] = self->keys[smallest];
+    self->handles[index] = self->handles[smallest];
+    index = smallest;
   }
+
+  self->keys[index] = key;
+  self->handles[index] = handle;
 }
 
-static void heapify_up(priority_queue_t *self)
+static void heapify_up(priority_queue_t *self, size_t index)
 {
-  if (self == NULL)
-  {
-    perror("priority queue pointer is null");
-    exit(EXIT_FAILURE);
-  }
+  const uint64_t key = self->keys[index];
+  void *handle = self->handles[index];
 
-  uint64_t index = self->size - 1;
+  size_t parent;
 
-  while (has_parent(self, index) && get_parent(self, index) > self->values[index].key)
+  while (index > PQ_ROOT && self->keys[parent = get_parent_index(index)] > key)
   {
-    swap(self, get_parent_index(index), index);
-    index = get_parent_index(index);
+    self->keys[index] = self->keys[parent];
+    self->handles[index] = self->handles[parent];
+    index = parent;
   }
+
+  self->keys[index] = key;
+  self->handles[index] = handle;
 }
@@ -2,36 +2,52 @@
 #define PRIORITY_QUEUE_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stddef.h>
 
-#define PQ_NODE_SIZE 512
+#define PQ_ARITY 4
 
-struct priority_queue_node
-{
-  uint64_t key;
-  uint8_t data[PQ_NODE_SIZE];
-};
+#define PQ_MIN_CAPACITY 16
 
-typedef struct priority_queue_node priority_queue_node_t;
+#define PQ_ROOT (PQ_ARITY - 1)
 
-#define PQ_MAX_NODES 10
+#define PQ_CACHE_LINE 64
 
+/**
+ * @brief Growable min-heap with PQ_ARITY children per node. Keys and payload
+ *        handles live in two parallel arrays, so sifting only walks the
+ *        densely packed keys.
+ *
+ * @note  The root sits at slot PQ_ROOT, so the children of every node start
+ *        at a multiple of PQ_ARITY. With the keys array aligned to
+ *        PQ_CACHE_LINE, the PQ_ARITY child keys compared per level share
+ *        one cache line.
+ *
+ * @note  The queue stores the caller's pointers as they are and never copies
+ *        or frees them. Peek and poll hand the same pointer back.
+ */
 struct priority_queue
 {
-  priority_queue_node_t values[PQ_MAX_NODES];
+  uint64_t *keys;
+  void **handles;
   size_t size;
+  size_t cap;
 };
 
 typedef struct priority_queue priority_queue_t;
 
-extern priority_queue_t *priority_queue_new(void);
+extern priority_queue_t *priority_queue_new(const size_t cap);
 
 extern void priority_queue_destroy(priority_queue_t *self);
 
 extern void *priority_queue_peek(priority_queue_t *self);
 
+extern bool priority_queue_peek_key(priority_queue_t *self, uint64_t *key);
+
 extern void *priority_queue_poll(priority_queue_t *self);
 
-extern void priority_queue_add(priority_queue_t *self, const uint64_t key, const void *data, const size_t size);
+extern void priority_queue_add(priority_queue_t *self, const uint64_t key, const void *data);
+
+extern size_t priority_queue_size(priority_queue_t *self);
 
 #endif/*PRIORITY_QUEUE_H*/
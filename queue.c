@@ -1,16 +1,16 @@
 #include "command.h"
+#include "internal/mpmc_ring.h"
 #include "queue.h"
 
-#include <immintrin.h>
-#include <pthread.h>
-#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
+/**
+ * @note Commands and callbacks are function pointers, which POSIX lets
+ *       round-trip through the void * slots of the ring.
+ */
 command_queue_t *command_queue_new(const size_t cap)
 {
   command_queue_t *self = NULL;
@@ -21,20 +21,7 @@ command_queue_t *command_queue_new(const size_t cap)
     exit(EXIT_FAILURE);
   }
 
-  self->items = (command_t *)calloc(cap, sizeof(*self->items));
-  if (self->items == NULL)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-    exit(EXIT_FAILURE);
-  }
-
-  if (pthread_mutex_init(&self->lock, NULL) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "could not init lock");
-    exit(EXIT_FAILURE);
-  }
-
-  self->cap = cap;
+  self->ring = mpmc_ring_new(cap);
   return self;
 }
 
@@ -42,11 +29,8 @@ void command_queue_destroy(command_queue_t *self)
 {
   if (self != NULL)
   {
-    if (self->items != NULL)
-    {
-      free(self->items);
-      self->items = NULL;
-    }
+    mpmc_ring_destroy(self->ring);
+    self->ring = NULL;
 
     free(self);
     self = NULL;
@@ -61,31 +45,7 @@ bool command_queue_enqueue(command_queue_t *self, command_t item)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  if ((self->w - self->r) >= self->cap)
-  {
-    if (pthread_mutex_unlock(&self->lock) < 0)
-    {
-      fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-      exit(EXIT_FAILURE);
-    }
-    return false;
-  }
-
-  self->items[self->w++ % self->cap] = item;
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return true;
+  return mpmc_ring_enqueue(self->ring, (const void *)item);
 }
 
 command_t command_queue_dequeue(command_queue_t *self)
@@ -96,32 +56,7 @@ command_t command_queue_dequeue(command_queue_t *self)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  if (self->r == self->w)
-  {
-    if (pthread_mutex_unlock(&self->lock) < 0)
-    {
-      fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-      exit(EXIT_FAILURE);
-    }
-    return NULL;
-  }
-
-  command_t command = NULL;
-  command = self->items[self->r++ % self->cap];
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return command;
+  return (command_t)mpmc_ring_dequeue(self->ring);
 }
 
 size_t command_queue_size(command_queue_t *self)
@@ -132,21 +67,7 @@ size_t command_queue_size(command_queue_t *self)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  const size_t size = self->w - self->r;
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return size;
+  return mpmc_ring_size(self->ring);
 }
 
 queue_t *queue_new(const size_t cap)
@@ -159,20 +80,7 @@ queue_t *queue_new(const size_t cap)
     exit(EXIT_FAILURE);
   }
 
-  self->items = (callback_t *)calloc(cap, sizeof(*self->items));
-  if (self->items == NULL)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-    exit(EXIT_FAILURE);
-  }
-
-  if (pthread_mutex_init(&self->lock, NULL) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "could not init lock");
-    exit(EXIT_FAILURE);
-  }
-
-  self->cap = cap;
+  self->ring = mpmc_ring_new(cap);
   return self;
 }
 
@@ -180,11 +88,8 @@ void queue_destroy(queue_t *self)
 {
   if (self != NULL)
   {
-    if (self->items != NULL)
-    {
-      free(self->items);
-      self->items = NULL;
-    }
+    mpmc_ring_destroy(self->ring);
+    self->ring = NULL;
 
     free(self);
     self = NULL;
@@ -199,31 +104,7 @@ bool queue_enqueue(queue_t *self, callback_t item)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  if ((self->w - self->r) >= self->cap)
-  {
-    if (pthread_mutex_unlock(&self->lock) < 0)
-    {
-      fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-      exit(EXIT_FAILURE);
-    }
-    return false;
-  }
-
-  self->items[self->w++ % self->cap] = item;
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return true;
+  return mpmc_ring_enqueue(self->ring, (const void *)item);
 }
 
 callback_t queue_dequeue(queue_t *self)
@@ -234,32 +115,7 @@ callback_t queue_dequeue(queue_t *self)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  if (self->r == self->w)
-  {
-    if (pthread_mutex_unlock(&self->lock) < 0)
-    {
-      fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-      exit(EXIT_FAILURE);
-    }
-    return NULL;
-  }
-
-  callback_t callback = NULL;
-  callback = self->items[self->r++ % self->cap];
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return callback;
+  return (callback_t)mpmc_ring_dequeue(self->ring);
 }
 
 size_t queue_size(queue_t *self)
@@ -270,19 +126,5 @@ size_t queue_size(queue_t *self)
     exit(EXIT_FAILURE);
   }
 
-  if (pthread_mutex_lock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  const size_t size = self->w - self->r;
-
-  if (pthread_mutex_unlock(&self->lock) < 0)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
-    exit(EXIT_FAILURE);
-  }
-
-  return size;
+  return mpmc_ring_size(self->ring);
 }
@@ -2,19 +2,21 @@
 #define QUEUE_H
 
 #include "command.h"
+#include "internal/mpmc_ring.h"
 
-#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdint.h>
 
+/**
+ * @brief Typed views of the library's bounded lock-free mpmc_ring, one
+ *        carrying commands and one carrying callbacks.
+ *
+ * @note  The capacity is rounded up to the next power of two. A NULL item
+ *        cannot be stored, it is the empty result of a dequeue.
+ */
 struct command_queue
 {
-  command_t *items;
-  size_t cap;
-  uint64_t w;
-  uint64_t r;
-  pthread_mutex_t lock;
+  mpmc_ring_t *ring;
 };
 
 typedef struct command_queue command_queue_t;
@@ -31,11 +33,7 @@ size_t command_queue_size(command_queue_t *self);
 
 struct queue
 {
-  callback_t *items;
-  size_t cap;
-  uint64_t w;
-  uint64_t r;
-  pthread_mutex_t lock;
+  mpmc_ring_t *ring;
 };
 
 typedef struct queue queue_t;
@@ -0,0 +1,272 @@
+#include "arena.h"
+#include "common.h"
+
+#include <jemalloc/jemalloc.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @note jemalloc never hands an arena index out twice, so the indices of
+ *       destroyed arenas are kept here for the next arena_new instead of
+ *       growing the arena count with every thread that comes and goes.
+ *       The arena itself lives on under its index, together with whatever
+ *       was still allocated from it.
+ */
+static pthread_mutex_t arena_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned arena_recycled[ARENA_RECYCLE_MAX];
+static size_t arena_recycled_count = 0UL;
+
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t arena_key;
+
+static _Thread_local arena_t *arena_current = NULL;
+
+static void arena_acquire(void)
+{
+  if (pthread_mutex_lock(&arena_lock) != 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "acquire lock error");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void arena_release(void)
+{
+  if (pthread_mutex_unlock(&arena_lock) != 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "release lock error");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static unsigned arena_create(const char *name)
+{
+  unsigned index;
+  size_t len = sizeof(index);
+
+  if (mallctl(name, &index, &len, NULL, 0) != 0)
+  {
+    fprintf(stderr, "%s(): %s %s\n", __func__, "could not create", name);
+    exit(EXIT_FAILURE);
+  }
+
+  return index;
+}
+
+arena_t *arena_new(void)
+{
+  arena_t *self = NULL;
+  self = (arena_t *)_calloc(1, sizeof(*self));
+
+  bool recycled = false;
+
+  arena_acquire();
+  if (arena_recycled_count > 0UL)
+  {
+    self->index = arena_recycled[--arena_recycled_count];
+    recycled = true;
+  }
+  arena_release();
+
+  if (false == recycled)
+  {
+    self->index = arena_create("arenas.create");
+  }
+
+  self->tcache = arena_create("tcache.create");
+  self->flags = MALLOCX_ARENA(self->index) | MALLOCX_TCACHE(self->tcache);
+
+  atomic_init(&self->allocations, 0UL);
+  atomic_init(&self->deallocations, 0UL);
+  atomic_init(&self->bytes_allocated, 0UL);
+  atomic_init(&self->bytes_freed, 0UL);
+
+  return self;
+}
+
+void arena_destroy(arena_t *self)
+{
+  char name[32];
+
+  if (self != NULL)
+  {
+    if (mallctl("tcache.destroy", NULL, NULL, &self->tcache, sizeof(self->tcache)) != 0)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not destroy thread cache");
+      exit(EXIT_FAILURE);
+    }
+
+    /**
+     * @note arena.<i>.reset would also drop the live allocations, a purge
+     *       only hands the unused dirty pages back to the system so the
+     *       next owner starts from what is still in use.
+     */
+    snprintf(name, sizeof(name), "arena.%u.purge", self->index);
+
+    if (mallctl(name, NULL, NULL, NULL, 0) != 0)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not purge arena");
+      exit(EXIT_FAILURE);
+    }
+
+    arena_acquire();
+    if (arena_recycled_count < ARENA_RECYCLE_MAX)
+    {
+      arena_recycled[arena_recycled_count++] = self->index;
+    }
+    arena_release();
+
+    __free(self);
+  }
+}
+
+/**
+ * @note Other destructors may still allocate or free during the teardown
+ *       of the thread, arena_self then creates a fresh arena that the key
+ *       hands back here on the next destructor pass.
+ */
+static void arena_exit(void *arena)
+{
+  if (arena_current == arena)
+  {
+    arena_current = NULL;
+  }
+
+  arena_destroy((arena_t *)arena);
+}
+
+static void arena_init_key(void)
+{
+  if (pthread_key_create(&arena_key, &arena_exit) != 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not create thread key");
+    exit(EXIT_FAILURE);
+  }
+}
+
+arena_t *arena_self(void)
+{
+  if (arena_current != NULL)
+  {
+    return arena_current;
+  }
+
+  if (pthread_once(&arena_once, &arena_init_key) != 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not initialize thread key");
+    exit(EXIT_FAILURE);
+  }
+
+  arena_current = arena_new();
+
+  if (pthread_setspecific(arena_key, arena_current) != 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not register thread arena");
+    exit(EXIT_FAILURE);
+  }
+
+  return arena_current;
+}
+
+/**
+ * @note Only the owner writes the counters, so a relaxed load and store is
+ *       enough and keeps the locked read-modify-write off the fast path.
+ */
+static void arena_count(atomic_uint_fast64_t *counter, const uint64_t n)
+{
+  atomic_store_explicit(counter,
+    atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+void *arena_malloc(arena_t *self, const size_t size)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "arena instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  void *ptr = NULL;
+
+  if (NULL == (ptr = mallocx((size > 0UL) ? size : 1UL, self->flags)))
+  {
+    die("a memory error occurred");
+  }
+
+  arena_count(&self->allocations, 1UL);
+  arena_count(&self->bytes_allocated, size);
+
+  return ptr;
+}
+
+void *arena_calloc(arena_t *self, const size_t nmemb, const size_t size)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "arena instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  void *ptr = NULL;
+  const size_t n = nmemb * size;
+
+  if (size > 0UL && n / size != nmemb)
+  {
+    die("allocation size overflow");
+  }
+
+  if (NULL == (ptr = mallocx((n > 0UL) ? n : 1UL, self->flags | MALLOCX_ZERO)))
+  {
+    die("a memory error occurred");
+  }
+
+  arena_count(&self->allocations, 1UL);
+  arena_count(&self->bytes_allocated, n);
+
+  return ptr;
+}
+
+void arena_free(arena_t *self, void *ptr, const size_t size)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "arena instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (ptr == NULL)
+  {
+    return;
+  }
+
+  if (size > 0UL)
+  {
+    sdallocx(ptr, size, MALLOCX_TCACHE(self->tcache));
+    arena_count(&self->bytes_freed, size);
+  }
+  else
+  {
+    dallocx(ptr, MALLOCX_TCACHE(self->tcache));
+  }
+
+  arena_count(&self->deallocations, 1UL);
+}
+
+void arena_stats(arena_t *self, arena_stats_t *stats)
+{
+  if (self == NULL || stats == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "arena and stats may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  stats->allocations = atomic_load_explicit(&self->allocations, memory_order_relaxed);
+  stats->deallocations = atomic_load_explicit(&self->deallocations, memory_order_relaxed);
+  stats->bytes_allocated = atomic_load_explicit(&self->bytes_allocated, memory_order_relaxed);
+  stats->bytes_freed = atomic_load_explicit(&self->bytes_freed, memory_order_relaxed);
+}
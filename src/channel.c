@@ -1,9 +1,18 @@
 #include "channel.h"
+#include "internal/byte_ring.h"
+#include "internal/spsc_ring.h"
 
 #include <turnpike/bipartite.h>
 
+#include <sys/eventfd.h>
+
+#include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 bidirectional_channel_t *bidirectional_channel_new(const size_t downstream_capacity,
                                                    const size_t upstream_capacity)
@@ -13,18 +22,302 @@ bidirectional_channel_t *bidirectional_channel_new(const size_t downstream_capac
 
   self->downstream = bipartite_queue_new(downstream_capacity, sizeof(int));
   self->upstream = bipartite_queue_new(upstream_capacity, sizeof(int));
+  self->eventfd = -1;
+
+  return self;
+}
+
+bidirectional_channel_t *bidirectional_channel_new_records(const size_t downstream_capacity,
+                                                           const size_t upstream_capacity,
+                                                           const size_t record_capacity)
+{
+  bidirectional_channel_t *self = NULL;
+  self = bidirectional_channel_new(downstream_capacity, upstream_capacity);
+
+  self->downstream_records = byte_ring_new(record_capacity);
+  self->upstream_records = byte_ring_new(record_capacity);
 
   return self;
 }
 
 void bidirectional_channel_destroy(bidirectional_channel_t *self)
 {
-  if (self == NULL)
+  size_t i;
+
+  if (self != NULL)
   {
     bipartite_queue_destroy(self->downstream);
     bipartite_queue_destroy(self->upstream);
 
+    byte_ring_destroy(self->downstream_records);
+    byte_ring_destroy(self->upstream_records);
+
+    spsc_ring_destroy(self->downstream_ring);
+    spsc_ring_destroy(self->upstream_ring);
+
+    for (i = 0; i < CHANNEL_PRIORITY_BANDS; i++)
+    {
+      spsc_ring_destroy(self->bands[i]);
+    }
+
+    if (self->eventfd >= 0)
+    {
+      close(self->eventfd);
+    }
+
     free(self);
     self = NULL;
   }
 }
+
+void bidirectional_channel_spsc(bidirectional_channel_t *self, const size_t downstream_capacity,
+                                const size_t upstream_capacity)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  self->downstream_ring = spsc_ring_new(downstream_capacity);
+  self->upstream_ring = spsc_ring_new(upstream_capacity);
+}
+
+void bidirectional_channel_eventfd(bidirectional_channel_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->eventfd >= 0)
+  {
+    return;
+  }
+
+  if ((self->eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not create eventfd");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @note A full counter (EAGAIN) already reads as readable, so the signal
+ *       is never lost.
+ */
+void channel_notify(bidirectional_channel_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const uint64_t one = 1UL;
+
+  if (self->eventfd < 0)
+  {
+    return;
+  }
+
+  while (write(self->eventfd, &one, sizeof(one)) < 0 && errno == EINTR)
+  {
+    continue;
+  }
+}
+
+void channel_rearm(bidirectional_channel_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  uint64_t count;
+
+  if (self->eventfd < 0)
+  {
+    return;
+  }
+
+  while (read(self->eventfd, &count, sizeof(count)) < 0 && errno == EINTR)
+  {
+    continue;
+  }
+}
+
+void bidirectional_channel_priority(bidirectional_channel_t *self, const size_t capacity)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t i;
+
+  for (i = 0; i < CHANNEL_PRIORITY_BANDS; i++)
+  {
+    self->bands[i] = spsc_ring_new(capacity);
+  }
+}
+
+bool channel_send_priority(bidirectional_channel_t *self, const uint32_t prio, const void *data)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t band = (prio < CHANNEL_PRIORITY_BANDS) ? prio : (CHANNEL_PRIORITY_BANDS - 1);
+
+  if (self->bands[band] == NULL)
+  {
+    return false;
+  }
+
+  return spsc_ring_push(self->bands[band], (void *)data);
+}
+
+size_t channel_receive_priority(bidirectional_channel_t *self, void **out, const size_t max)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t n = 0UL;
+  size_t i;
+
+  if (self->bands[0] == NULL)
+  {
+    return 0UL;
+  }
+
+  for (i = CHANNEL_PRIORITY_BANDS; i > 0 && n < max; i--)
+  {
+    n += spsc_ring_pop_many(self->bands[i - 1], &out[n], max - n);
+  }
+
+  return n;
+}
+
+size_t channel_priority_size(bidirectional_channel_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t n = 0UL;
+  size_t i;
+
+  if (self->bands[0] == NULL)
+  {
+    return 0UL;
+  }
+
+  for (i = 0; i < CHANNEL_PRIORITY_BANDS; i++)
+  {
+    n += spsc_ring_size(self->bands[i]);
+  }
+
+  return n;
+}
+
+static byte_ring_t *channel_records(bidirectional_channel_t *self, const int direction)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return (direction == CHANNEL_UPSTREAM)
+    ? self->upstream_records
+    : self->downstream_records;
+}
+
+bool channel_send(bidirectional_channel_t *self, const int direction, const void *data, const size_t len)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    return false;
+  }
+
+  return byte_ring_write(ring, data, len);
+}
+
+bool channel_receive(bidirectional_channel_t *self, const int direction, void *out, size_t *len)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    if (len != NULL)
+    {
+      *len = 0UL;
+    }
+    return false;
+  }
+
+  return byte_ring_read(ring, out, len);
+}
+
+void *channel_reserve(bidirectional_channel_t *self, const int direction, const size_t len)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    return NULL;
+  }
+
+  return byte_ring_reserve(ring, len);
+}
+
+bool channel_commit(bidirectional_channel_t *self, const int direction, const size_t len)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel has no record ring");
+    exit(EXIT_FAILURE);
+  }
+
+  return byte_ring_commit(ring, len);
+}
+
+const void *channel_peek(bidirectional_channel_t *self, const int direction, size_t *len)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    return NULL;
+  }
+
+  return byte_ring_peek(ring, len);
+}
+
+void channel_release(bidirectional_channel_t *self, const int direction)
+{
+  byte_ring_t *ring = channel_records(self, direction);
+
+  if (ring == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "channel has no record ring");
+    exit(EXIT_FAILURE);
+  }
+
+  byte_ring_release(ring);
+}
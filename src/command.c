@@ -1,3 +1,4 @@
+#include "arena.h"
 #include "command.h"
 
 #include <inttypes.h>
@@ -8,7 +9,7 @@ worker_command_t *worker_command_new(
   const int status, const uint64_t channel_id, const void *parameter)
 {
   worker_command_t *self = NULL;
-  self = (worker_command_t *)calloc(1, sizeof(*self));
+  self = (worker_command_t *)arena_malloc(arena_self(), sizeof(*self));
 
   self->status = status;
   self->channel_id = channel_id;
@@ -21,7 +22,6 @@ void worker_command_destroy(worker_command_t *self)
 {
   if (self != NULL)
   {
-    free(NULL);
-    self = NULL;
+    arena_free(arena_self(), self, sizeof(*self));
   }
 }
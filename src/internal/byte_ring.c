@@ -0,0 +1,255 @@
+#include "common.h"
+#include "internal/byte_ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BYTE_RING_MIN_CAPACITY    64UL
+
+static size_t byte_ring_align(const size_t len)
+{
+  return (len + (BYTE_RING_HEADER - 1UL)) & ~(BYTE_RING_HEADER - 1UL);
+}
+
+byte_ring_t *byte_ring_new(const size_t cap)
+{
+  byte_ring_t *self = NULL;
+  self = (byte_ring_t *)_calloc(1, sizeof(*self));
+
+  size_t n = BYTE_RING_MIN_CAPACITY;
+
+  while (n < cap)
+  {
+    n <<= 1UL;
+  }
+
+  self->buffer = (uint8_t *)_calloc(n, sizeof(*self->buffer));
+  self->mask = n - 1UL;
+
+  hf_ring_cursors_init(&self->cursors);
+  atomic_init(&self->committed, 0UL);
+  atomic_init(&self->released, 0UL);
+
+  self->reserved_len = BYTE_RING_NONE;
+
+  return self;
+}
+
+void byte_ring_destroy(byte_ring_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self->buffer);
+    __free(self);
+  }
+}
+
+size_t byte_ring_max_record(const byte_ring_t *self)
+{
+  return ((self->mask + 1UL) / 2UL) - BYTE_RING_HEADER;
+}
+
+void *byte_ring_reserve(byte_ring_t *self, const size_t len)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t cap = self->mask + 1UL;
+  const size_t total = BYTE_RING_HEADER + byte_ring_align(len);
+  size_t pos;
+  size_t gap;
+  size_t need;
+
+  if (len > byte_ring_max_record(self))
+  {
+    return NULL;
+  }
+
+  pos = atomic_load_explicit(&self->cursors.w, memory_order_relaxed);
+  gap = cap - (pos & self->mask);
+  need = (gap < total) ? (gap + total) : total;
+
+  if (hf_ring_room(&self->cursors, cap, pos, need) < need)
+  {
+    return NULL;
+  }
+
+  if (gap < total)
+  {
+    *(uint64_t *)&self->buffer[pos & self->mask] = BYTE_RING_WRAP;
+    pos += gap;
+  }
+
+  self->reserved = pos;
+  self->reserved_len = len;
+
+  return &self->buffer[(pos & self->mask) + BYTE_RING_HEADER];
+}
+
+bool byte_ring_commit(byte_ring_t *self, const size_t len)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = self->reserved;
+
+  /**
+   * @note Anything past the reservation would run into the header of the
+   *       next record, or past the end of the buffer.
+   */
+  if (self->reserved_len == BYTE_RING_NONE || len > self->reserved_len)
+  {
+    return false;
+  }
+
+  self->reserved_len = BYTE_RING_NONE;
+
+  *(uint64_t *)&self->buffer[pos & self->mask] = (uint64_t)len;
+  atomic_store_explicit(&self->committed,
+    atomic_load_explicit(&self->committed, memory_order_relaxed) + 1UL, memory_order_release);
+  atomic_store_explicit(&self->cursors.w,
+    pos + BYTE_RING_HEADER + byte_ring_align(len), memory_order_release);
+
+  return true;
+}
+
+const void *byte_ring_peek(byte_ring_t *self, size_t *len)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t pos;
+  uint64_t header;
+
+  pos = atomic_load_explicit(&self->cursors.r, memory_order_relaxed);
+
+  if (0UL == hf_ring_ready(&self->cursors, pos, 1UL))
+  {
+    return NULL;
+  }
+
+  header = *(uint64_t *)&self->buffer[pos & self->mask];
+
+  /**
+   * @note A wrap marker is only ever published together with the record
+   *       that follows it, so the ring cannot be empty after skipping.
+   */
+  if (header == BYTE_RING_WRAP)
+  {
+    pos += (self->mask + 1UL) - (pos & self->mask);
+    atomic_store_explicit(&self->cursors.r, pos, memory_order_release);
+    header = *(uint64_t *)&self->buffer[pos & self->mask];
+  }
+
+  if (len != NULL)
+  {
+    *len = (size_t)header;
+  }
+
+  return &self->buffer[(pos & self->mask) + BYTE_RING_HEADER];
+}
+
+void byte_ring_release(byte_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = atomic_load_explicit(&self->cursors.r, memory_order_relaxed);
+  const uint64_t header = *(uint64_t *)&self->buffer[pos & self->mask];
+
+  atomic_store_explicit(&self->released,
+    atomic_load_explicit(&self->released, memory_order_relaxed) + 1UL, memory_order_release);
+  atomic_store_explicit(&self->cursors.r,
+    pos + BYTE_RING_HEADER + byte_ring_align((size_t)header), memory_order_release);
+}
+
+bool byte_ring_write(byte_ring_t *self, const void *data, const size_t len)
+{
+  void *payload = NULL;
+
+  if (NULL == (payload = byte_ring_reserve(self, len)))
+  {
+    return false;
+  }
+
+  memcpy(payload, data, len);
+
+  return byte_ring_commit(self, len);
+}
+
+bool byte_ring_read(byte_ring_t *self, void *out, size_t *len)
+{
+  if (len == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "length pointer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const void *payload = NULL;
+  size_t n = 0UL;
+
+  if (NULL == (payload = byte_ring_peek(self, &n)))
+  {
+    *len = 0UL;
+    return false;
+  }
+
+  if (n > *len)
+  {
+    *len = n;
+    return false;
+  }
+
+  memcpy(out, payload, n);
+  byte_ring_release(self);
+
+  *len = n;
+
+  return true;
+}
+
+/**
+ * @note released is read first: it never passes committed, so a record
+ *       released in between is at worst still counted, never negative.
+ */
+size_t byte_ring_size(byte_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t released = atomic_load_explicit(&self->released, memory_order_acquire);
+  const size_t committed = atomic_load_explicit(&self->committed, memory_order_acquire);
+
+  return committed - released;
+}
+
+bool byte_ring_empty(byte_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return 0UL == hf_ring_size(&self->cursors);
+}
@@ -1,5 +1,7 @@
+#include "arena.h"
 #include "common.h"
 #include "internal/command.h"
+#include "internal/mpmc_ring.h"
 
 #include <turnpike/bipartite.h>
 
@@ -12,19 +14,107 @@
 command_t *command_new(const int status, const uint64_t channel_id, command_callback_t callback, const void *parameter)
 {
   command_t *self = NULL;
-  self = (command_t *)_calloc(1, sizeof(*self));
+  self = (command_t *)arena_malloc(arena_self(), sizeof(*self));
 
   self->status = status;
+  self->result = COMMAND_RESULT_NONE;
   self->channel_id = channel_id;
   self->callback = callback;
   self->parameter = (void *)parameter;
+  self->count = 0UL;
 
   return self;
 }
 
+/**
+ * @note Overflow commands are usually freed by another thread than the one
+ *       that allocated them, the sized free goes through the cache of the
+ *       freeing thread instead of the default arena.
+ */
 void command_destroy(command_t *self)
 {
-  __free(self);
+  arena_free(arena_self(), self, sizeof(*self));
+}
+
+command_pool_t *command_pool_new(const size_t cap)
+{
+  command_pool_t *self = NULL;
+  self = (command_pool_t *)_calloc(1, sizeof(*self));
+
+  uint64_t i;
+
+  self->slab = (command_t *)_calloc(cap, sizeof(*self->slab));
+  self->free = mpmc_ring_new(cap);
+  self->cap = cap;
+
+  for (i = 0; i < cap; i++)
+  {
+    mpmc_ring_enqueue(self->free, &self->slab[i]);
+  }
+
+  return self;
+}
+
+void command_pool_destroy(command_pool_t *self)
+{
+  if (self != NULL)
+  {
+    if (self->free != NULL)
+    {
+      mpmc_ring_destroy(self->free);
+    }
+
+    __free(self->slab);
+    __free(self);
+  }
+}
+
+command_t *command_pool_acquire(command_pool_t *self, const int status, const uint64_t channel_id, command_callback_t callback, const void *parameter)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "command pool instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  command_t *command = NULL;
+  command = (command_t *)mpmc_ring_dequeue(self->free);
+
+  if (command == NULL)
+  {
+    return command_new(status, channel_id, callback, parameter);
+  }
+
+  command->status = status;
+  command->result = COMMAND_RESULT_NONE;
+  command->channel_id = channel_id;
+  command->callback = callback;
+  command->parameter = (void *)parameter;
+  command->count = 0UL;
+
+  return command;
+}
+
+void command_pool_release(command_pool_t *self, command_t *command)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "command pool instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (command == NULL)
+  {
+    return;
+  }
+
+  if (command < self->slab || command >= (self->slab + self->cap))
+  {
+    command_destroy(command);
+    return;
+  }
+
+  mpmc_ring_enqueue(self->free, command);
 }
 
 void command_print(const command_t *self)
@@ -89,6 +179,40 @@ void *command_read(command_t *self, bipartite_queue_t *queue, const bool probe)
   return bipartite_queue_dequeue(queue);
 }
 
+/**
+ * @note This method is inherently protected by the scheduler.
+ */
+void *command_read_many(command_t *self, bipartite_queue_t *queue, const bool probe)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "command instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (probe)
+  {
+    return NULL;
+  }
+
+  void **items = (void **)self->parameter;
+  size_t i;
+
+  for (i = 0; i < self->count; i++)
+  {
+    items[i] = bipartite_queue_dequeue(queue);
+
+    if (items[i] == NULL)
+    {
+      break;
+    }
+  }
+
+  self->result = COMMAND_RESULT_SUCCESS;
+  self->count = i;
+  return NULL;
+}
+
 /**
  * @note This method is inherently protected by the scheduler.
  */
@@ -106,8 +230,43 @@ void *command_write(command_t *self, bipartite_queue_t *queue, const bool probe)
     return NULL;
   }
 
-  bool *result = NULL;
-  result = (bool *)_calloc(1, sizeof(*result));
-  *result = bipartite_queue_enqueue(queue, self->parameter);
-  return result;
+  self->result = bipartite_queue_enqueue(queue, self->parameter)
+    ? COMMAND_RESULT_SUCCESS
+    : COMMAND_RESULT_FAILURE;
+  return NULL;
+}
+
+/**
+ * @note This method is inherently protected by the scheduler.
+ */
+void *command_write_many(command_t *self, bipartite_queue_t *queue, const bool probe)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "command instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (probe)
+  {
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "command: probe");
+    return NULL;
+  }
+
+  const void **items = (const void **)self->parameter;
+  size_t i;
+
+  for (i = 0; i < self->count; i++)
+  {
+    if (false == bipartite_queue_enqueue(queue, items[i]))
+    {
+      break;
+    }
+  }
+
+  self->result = (i > 0)
+    ? COMMAND_RESULT_SUCCESS
+    : COMMAND_RESULT_FAILURE;
+  self->count = i;
+  return NULL;
 }
@@ -0,0 +1,54 @@
+#include "internal/futex.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+void futex_wait(atomic_uint *word, const unsigned int expected)
+{
+  if (syscall(SYS_futex, (unsigned int *)word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0) < 0)
+  {
+    if (errno != EAGAIN && errno != EINTR)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+bool futex_wait_timed(atomic_uint *word, const unsigned int expected, const struct timespec *timeout)
+{
+  if (syscall(SYS_futex, (unsigned int *)word, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0) < 0)
+  {
+    if (errno == ETIMEDOUT)
+    {
+      return false;
+    }
+
+    if (errno != EAGAIN && errno != EINTR)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  return true;
+}
+
+void futex_wake(atomic_uint *word, const int count)
+{
+  if (syscall(SYS_futex, (unsigned int *)word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+}
@@ -0,0 +1,155 @@
+#include "common.h"
+#include "internal/hash_ring.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+uint64_t hash_ring_hash(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15UL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+  return x ^ (x >> 31);
+}
+
+static int hash_ring_compare(const void *a, const void *b)
+{
+  const struct hash_ring_node *x = a;
+  const struct hash_ring_node *y = b;
+
+  if (x->hash != y->hash)
+  {
+    return (x->hash < y->hash) ? -1 : 1;
+  }
+
+  return (x->id < y->id) ? -1 : (x->id > y->id);
+}
+
+hash_ring_t *hash_ring_new(const size_t max_members)
+{
+  hash_ring_t *self = NULL;
+  self = (hash_ring_t *)_calloc(1, sizeof(*self));
+  self->nodes = (struct hash_ring_node *)_calloc((max_members * HASH_RING_REPLICAS), sizeof(*self->nodes));
+  self->cap = max_members * HASH_RING_REPLICAS;
+  self->count = 0UL;
+  return self;
+}
+
+void hash_ring_destroy(hash_ring_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self->nodes);
+    __free(self);
+  }
+}
+
+bool hash_ring_add(hash_ring_t *self, const uint64_t id)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  uint64_t r;
+  size_t i;
+
+  if ((self->count + HASH_RING_REPLICAS) > self->cap)
+  {
+    return false;
+  }
+
+  for (i = 0; i < self->count; i++)
+  {
+    if (self->nodes[i].id == id)
+    {
+      return false;
+    }
+  }
+
+  /**
+   * @note The points are hashed off the hash of the id, not the id itself:
+   *       small ids and small keys would otherwise hash to the very same
+   *       points, and member 0 would own keys 0 to HASH_RING_REPLICAS - 1.
+   */
+  for (r = 0; r < HASH_RING_REPLICAS; r++)
+  {
+    self->nodes[self->count].hash = hash_ring_hash(hash_ring_hash(id) + r);
+    self->nodes[self->count].id = id;
+    self->count++;
+  }
+
+  qsort(self->nodes, self->count, sizeof(*self->nodes), &hash_ring_compare);
+
+  return true;
+}
+
+bool hash_ring_remove(hash_ring_t *self, const uint64_t id)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t i;
+  size_t j = 0UL;
+
+  for (i = 0; i < self->count; i++)
+  {
+    if (self->nodes[i].id != id)
+    {
+      self->nodes[j++] = self->nodes[i];
+    }
+  }
+
+  if (j == self->count)
+  {
+    return false;
+  }
+
+  self->count = j;
+
+  return true;
+}
+
+bool hash_ring_lookup(const hash_ring_t *self, const uint64_t key, uint64_t *id)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const uint64_t hash = hash_ring_hash(key);
+  size_t lo = 0UL;
+  size_t hi = self->count;
+  size_t mid;
+
+  if (self->count == 0UL)
+  {
+    return false;
+  }
+
+  while (lo < hi)
+  {
+    mid = lo + ((hi - lo) / 2UL);
+
+    if (self->nodes[mid].hash < hash)
+    {
+      lo = mid + 1UL;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  *id = self->nodes[(lo == self->count) ? 0UL : lo].id;
+
+  return true;
+}
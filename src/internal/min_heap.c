@@ -0,0 +1,137 @@
+#include "common.h"
+#include "internal/min_heap.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool min_heap_less(const min_heap_t *self, const uint64_t a, const uint64_t b)
+{
+  const uint64_t x = self->heap[a];
+  const uint64_t y = self->heap[b];
+
+  if (self->keys[x] != self->keys[y])
+  {
+    return self->keys[x] < self->keys[y];
+  }
+
+  return x < y;
+}
+
+static void min_heap_swap(min_heap_t *self, const uint64_t a, const uint64_t b)
+{
+  const uint64_t temp = self->heap[a];
+  self->heap[a] = self->heap[b];
+  self->heap[b] = temp;
+
+  self->index[self->heap[a]] = a;
+  self->index[self->heap[b]] = b;
+}
+
+static void min_heap_sift_up(min_heap_t *self, uint64_t pos)
+{
+  uint64_t parent;
+
+  while (pos > 0)
+  {
+    parent = (pos - 1UL) / 2UL;
+
+    if (false == min_heap_less(self, pos, parent))
+    {
+      break;
+    }
+
+    min_heap_swap(self, pos, parent);
+    pos = parent;
+  }
+}
+
+static void min_heap_sift_down(min_heap_t *self, uint64_t pos)
+{
+  uint64_t child;
+
+  while ((child = (2UL * pos) + 1UL) < self->size)
+  {
+    if ((child + 1UL) < self->size && min_heap_less(self, child + 1UL, child))
+    {
+      child++;
+    }
+
+    if (false == min_heap_less(self, child, pos))
+    {
+      break;
+    }
+
+    min_heap_swap(self, pos, child);
+    pos = child;
+  }
+}
+
+min_heap_t *min_heap_new(const uint64_t *keys, const size_t size)
+{
+  min_heap_t *self = NULL;
+  self = (min_heap_t *)_calloc(1, sizeof(*self));
+
+  uint64_t i;
+
+  self->heap = (uint64_t *)_calloc(size, sizeof(*self->heap));
+  self->index = (uint64_t *)_calloc(size, sizeof(*self->index));
+  self->keys = keys;
+  self->size = size;
+
+  for (i = 0; i < size; i++)
+  {
+    self->heap[i] = i;
+    self->index[i] = i;
+  }
+
+  for (i = size / 2UL; i-- > 0;)
+  {
+    min_heap_sift_down(self, i);
+  }
+
+  return self;
+}
+
+void min_heap_destroy(min_heap_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self->heap);
+    __free(self->index);
+    __free(self);
+  }
+}
+
+uint64_t min_heap_peek(const min_heap_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "heap instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return self->heap[0];
+}
+
+void min_heap_update(min_heap_t *self, const uint64_t i)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "heap instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (i >= self->size)
+  {
+    fprintf(stderr, "%s(%lu): %s\n", __func__, i, "index is out of bounds");
+    return;
+  }
+
+  const uint64_t pos = self->index[i];
+
+  min_heap_sift_up(self, pos);
+  min_heap_sift_down(self, self->index[i]);
+}
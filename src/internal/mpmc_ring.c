@@ -0,0 +1,163 @@
+#include "common.h"
+#include "internal/mpmc_ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static size_t mpmc_ring_round_up(const size_t cap)
+{
+  size_t n = 2UL;
+
+  while (n < cap)
+  {
+    n <<= 1UL;
+  }
+
+  return n;
+}
+
+mpmc_ring_t *mpmc_ring_new(const size_t cap)
+{
+  mpmc_ring_t *self = NULL;
+  self = (mpmc_ring_t *)_calloc(1, sizeof(*self));
+
+  const size_t n = mpmc_ring_round_up(cap);
+  size_t i;
+
+  self->cells = (struct mpmc_ring_cell *)_malloc(n * sizeof(*self->cells));
+
+  for (i = 0; i < n; i++)
+  {
+    atomic_init(&self->cells[i].sequence, i);
+  }
+
+  atomic_init(&self->enqueue_pos, 0UL);
+  atomic_init(&self->dequeue_pos, 0UL);
+
+  self->mask = n - 1UL;
+
+  return self;
+}
+
+void mpmc_ring_destroy(mpmc_ring_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self->cells);
+    __free(self);
+  }
+}
+
+bool mpmc_ring_enqueue(mpmc_ring_t *self, const void *data)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  struct mpmc_ring_cell *cell = NULL;
+  size_t pos;
+  size_t seq;
+  intptr_t dif;
+
+  pos = atomic_load_explicit(&self->enqueue_pos, memory_order_relaxed);
+
+  for (;;)
+  {
+    cell = &self->cells[pos & self->mask];
+    seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    dif = (intptr_t)seq - (intptr_t)pos;
+
+    if (dif == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&self->enqueue_pos, &pos, pos + 1UL,
+            memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (dif < 0)
+    {
+      return false;
+    }
+    else
+    {
+      pos = atomic_load_explicit(&self->enqueue_pos, memory_order_relaxed);
+    }
+  }
+
+  cell->data = (void *)data;
+  atomic_store_explicit(&cell->sequence, pos + 1UL, memory_order_release);
+
+  return true;
+}
+
+void *mpmc_ring_dequeue(mpmc_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  struct mpmc_ring_cell *cell = NULL;
+  void *data = NULL;
+  size_t pos;
+  size_t seq;
+  intptr_t dif;
+
+  pos = atomic_load_explicit(&self->dequeue_pos, memory_order_relaxed);
+
+  for (;;)
+  {
+    cell = &self->cells[pos & self->mask];
+    seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    dif = (intptr_t)seq - (intptr_t)(pos + 1UL);
+
+    if (dif == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&self->dequeue_pos, &pos, pos + 1UL,
+            memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (dif < 0)
+    {
+      return NULL;
+    }
+    else
+    {
+      pos = atomic_load_explicit(&self->dequeue_pos, memory_order_relaxed);
+    }
+  }
+
+  data = cell->data;
+  atomic_store_explicit(&cell->sequence, pos + self->mask + 1UL, memory_order_release);
+
+  return data;
+}
+
+size_t mpmc_ring_size(mpmc_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t w = atomic_load_explicit(&self->enqueue_pos, memory_order_relaxed);
+  const size_t r = atomic_load_explicit(&self->dequeue_pos, memory_order_relaxed);
+
+  return (w > r) ? (w - r) : 0UL;
+}
+
+bool mpmc_ring_empty(mpmc_ring_t *self)
+{
+  return 0UL == mpmc_ring_size(self);
+}
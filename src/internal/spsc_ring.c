@@ -0,0 +1,141 @@
+#include "common.h"
+#include "internal/spsc_ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+spsc_ring_t *spsc_ring_new(const size_t cap)
+{
+  spsc_ring_t *self = NULL;
+  self = (spsc_ring_t *)_calloc(1, sizeof(*self));
+
+  size_t n = 2UL;
+
+  while (n < cap)
+  {
+    n <<= 1UL;
+  }
+
+  self->items = (void **)_malloc(n * sizeof(*self->items));
+  self->mask = n - 1UL;
+
+  hf_ring_cursors_init(&self->cursors);
+
+  return self;
+}
+
+void spsc_ring_destroy(spsc_ring_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self->items);
+    __free(self);
+  }
+}
+
+bool spsc_ring_push(spsc_ring_t *self, void *item)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = atomic_load_explicit(&self->cursors.w, memory_order_relaxed);
+
+  if (0UL == hf_ring_room(&self->cursors, self->mask + 1UL, pos, 1UL))
+  {
+    return false;
+  }
+
+  self->items[pos & self->mask] = item;
+  atomic_store_explicit(&self->cursors.w, pos + 1UL, memory_order_release);
+
+  return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *self, void **out)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = atomic_load_explicit(&self->cursors.r, memory_order_relaxed);
+
+  if (0UL == hf_ring_ready(&self->cursors, pos, 1UL))
+  {
+    return false;
+  }
+
+  *out = self->items[pos & self->mask];
+  atomic_store_explicit(&self->cursors.r, pos + 1UL, memory_order_release);
+
+  return true;
+}
+
+size_t spsc_ring_push_many(spsc_ring_t *self, void *const *items, const size_t n)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = atomic_load_explicit(&self->cursors.w, memory_order_relaxed);
+  const size_t room = hf_ring_room(&self->cursors, self->mask + 1UL, pos, n);
+  const size_t count = (n < room) ? n : room;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    self->items[(pos + i) & self->mask] = items[i];
+  }
+
+  atomic_store_explicit(&self->cursors.w, pos + count, memory_order_release);
+
+  return count;
+}
+
+size_t spsc_ring_pop_many(spsc_ring_t *self, void **out, const size_t max)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const size_t pos = atomic_load_explicit(&self->cursors.r, memory_order_relaxed);
+  const size_t ready = hf_ring_ready(&self->cursors, pos, max);
+  const size_t count = (max < ready) ? max : ready;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    out[i] = self->items[(pos + i) & self->mask];
+  }
+
+  atomic_store_explicit(&self->cursors.r, pos + count, memory_order_release);
+
+  return count;
+}
+
+size_t spsc_ring_size(spsc_ring_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "ring instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return hf_ring_size(&self->cursors);
+}
+
+bool spsc_ring_empty(spsc_ring_t *self)
+{
+  return 0UL == spsc_ring_size(self);
+}
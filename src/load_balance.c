@@ -1,27 +1,61 @@
 #include "channel.h"
-#include "command.h"
 #include "common.h"
 #include "load_balance.h"
 #include "observable.h"
-#include "internal/util.h"
+#include "internal/hash_ring.h"
+#include "internal/spsc_ring.h"
+#include "retry.h"
 #include "scheduler.h"
+#include "strategy.h"
 
 #include <turnpike/bipartite.h>
-#include <turnpike/queue.h>
 
 #include <inttypes.h>
+#include <sched.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-load_balancer_t *load_balancer_new(const size_t max_queue, const size_t cap)
+static const strategy_t *load_balancer_strategy(const int policy)
+{
+  switch (policy)
+  {
+    case LOAD_BALANCER_POLICY_TWO_CHOICES:     return &strategy_two_choices;
+    case LOAD_BALANCER_POLICY_ROUND_ROBIN:     return &strategy_round_robin;
+    case LOAD_BALANCER_POLICY_WEIGHTED:        return &strategy_weighted;
+    case LOAD_BALANCER_POLICY_CONSISTENT_HASH: return &strategy_consistent_hash;
+    case LOAD_BALANCER_POLICY_LEAST_LOADED:
+    default:                                   return &strategy_least_loaded;
+  }
+}
+
+static void load_balancer_retried(const retry_record_t *record, const int failure,
+  void *result, void *args);
+
+load_balancer_t *load_balancer_new(scheduler_t *scheduler, const size_t cap, const int policy)
 {
   load_balancer_t *self = NULL;
   self = (load_balancer_t *)_calloc(1, sizeof(*self));
-  self->inbound_queue = queue_new(max_queue * sizeof(worker_command_t *), sizeof(worker_command_t *));
-  self->outbound_queue = queue_new(max_queue * sizeof(worker_command_t *), sizeof(worker_command_t *));
+  self->retry = retry_new(scheduler, &load_balancer_retried);
   self->distribution = (uint64_t *)_calloc(cap, sizeof(*self->distribution));
+  self->weights = (uint64_t *)_calloc(cap, sizeof(*self->weights));
+  self->moved_in = (atomic_uint_fast64_t *)_calloc(cap, sizeof(*self->moved_in));
+  self->moved_out = (atomic_uint_fast64_t *)_calloc(cap, sizeof(*self->moved_out));
   self->cap = cap;
+
+  uint64_t k;
+
+  for (k = 0; k < cap; k++)
+  {
+    self->weights[k] = 1UL;
+    atomic_init(&self->moved_in[k], 0UL);
+    atomic_init(&self->moved_out[k], 0UL);
+  }
+
+  self->ring = hash_ring_new(cap);
+  self->reserved = LOAD_BALANCER_RESERVED_NONE;
+  load_balancer_set_strategy(self, load_balancer_strategy(policy));
   return self;
 }
 
@@ -29,133 +63,134 @@ void load_balancer_destroy(load_balancer_t *self)
 {
   if (self != NULL)
   {
-    if (self->inbound_queue != NULL)
+    if (self->retry != NULL)
+    {
+      retry_destroy(self->retry);
+    }
+
+    if (self->strategy != NULL)
     {
-      queue_destroy(self->inbound_queue);
+      self->strategy->destroy(self->state);
     }
 
-    if (self->outbound_queue != NULL)
+    if (self->ring != NULL)
     {
-      queue_destroy(self->outbound_queue);
+      hash_ring_destroy(self->ring);
     }
 
     __free(self->distribution);
+    __free(self->weights);
+    __free(self->moved_in);
+    __free(self->moved_out);
 
     free(self);
     self = NULL;
   }
 }
 
-static void scheduler_retry_enqueue(scheduler_t *scheduler,
-  queue_t *queue, const int failure, const uint64_t channel_id,
-  const void *data,
-  void *(*schedule)(worker_command_t *, void *),
-  void *(*execute)(worker_command_t *, void *),
-  void *(*nodefect)(worker_command_t *, void *),
-  void *(*complete)(worker_command_t *, void *), void *args)
+void load_balancer_set_strategy(load_balancer_t *self, const strategy_t *strategy)
 {
-  worker_command_t *cmd = NULL;
+  if (self == NULL || strategy == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "load balancer and strategy may not be null");
+    exit(EXIT_FAILURE);
+  }
 
-  switch (failure)
+  if (self->strategy != NULL)
   {
-    case SCHEDULER_FAILURE_SAVE:
-#if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: failed schedule");
-#endif/*NDEBUG*/
-      cmd = worker_command_new(SCHEDULER_STATE_SAVE, channel_id, data);
-      if (false == queue_enqueue(queue, &cmd))
-      {
-        fprintf(stderr, "[publisher] %s(): %s\n",
-          __func__, "could not enqueue into local queue");
-        exit(EXIT_FAILURE);
-      }
-      if (NULL != schedule) { schedule(cmd, args); }
-      break;
+    self->strategy->destroy(self->state);
+  }
 
-    case SCHEDULER_FAILURE_EARLY_RELEASE:
-    case SCHEDULER_FAILURE_EXECUTE:
-#if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: failed execute");
-#endif/*NDEBUG*/
-      cmd = worker_command_new(SCHEDULER_STATE_EXECUTE, channel_id, data);
-      if (false == queue_enqueue(queue, &cmd))
-      {
-        fprintf(stderr, "[publisher] %s(): %s\n",
-          __func__, "could not enqueue into local queue");
-        exit(EXIT_FAILURE);
-      }
-      if (NULL != execute) { execute(cmd, args); }
-      break;
+  self->strategy = strategy;
+  self->state = strategy->create(self);
+}
 
-    case SCHEDULER_FAILURE_NODEFECT:
-#if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: failed nodefect");
-#endif/*NDEBUG*/
-      if (NULL != nodefect) { nodefect(cmd, args); }
-      break;
+bool load_balancer_set_weight(load_balancer_t *self, const uint64_t k, const uint64_t weight)
+{
+  if (self == NULL || k >= self->cap)
+  {
+    return false;
+  }
 
-    case SCHEDULER_FAILURE_SUCCESSFUL:
-#if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: failed successful");
-#endif/*NDEBUG*/
-      if (NULL != complete) { complete(cmd, args); }
-      break;
+  self->weights[k] = weight;
 
-    default:
-      fprintf(stderr, "[publisher] %s(): %s\n",
-        __func__, "unknown scheduler failure state");
-      exit(EXIT_FAILURE);
-  }
+  return true;
 }
 
-struct load_balancer_arguments
+bool load_balancer_join(load_balancer_t *self, const uint64_t k)
 {
-  load_balancer_t *self;
-  uint64_t k;
-};
+  if (self == NULL || k >= self->cap)
+  {
+    return false;
+  }
 
-void *on_nodefect(worker_command_t *cmd, void *args)
+  return hash_ring_add(self->ring, k);
+}
+
+static void load_balancer_delivered(load_balancer_t *self, const uint64_t k, const uint64_t n)
 {
-  if (args == NULL)
+  self->distribution[k] += n;
+
+  if (self->strategy->on_delivered != NULL)
   {
-    fprintf(stderr, "%s(): %s\n", __func__, "callback arguments may not be null");
-    exit(EXIT_FAILURE);
+    self->strategy->on_delivered(self, self->state, k, n);
   }
+}
 
-  struct load_balancer_arguments *self = NULL;
-  self = (struct load_balancer_arguments *)args;
-
-  self->self->distribution[self->k] += 1UL;
-  self->self->i = self->k;
+static void load_balancer_acked(load_balancer_t *self, const uint64_t k, const uint64_t n)
+{
+  self->distribution[k] -= n;
 
-  return NULL;
+  if (self->strategy->on_acked != NULL)
+  {
+    self->strategy->on_acked(self, self->state, k, n);
+  }
 }
 
-void *on_nodefect_2(worker_command_t *cmd, void *args)
+void load_balancer_moved(load_balancer_t *self, const uint64_t from, const uint64_t to, const uint64_t n)
 {
-  if (args == NULL)
+  if (self == NULL || from >= self->cap || to >= self->cap)
   {
-    fprintf(stderr, "%s(): %s\n", __func__, "callback arguments may not be null");
-    exit(EXIT_FAILURE);
+    return;
   }
 
-  struct load_balancer_arguments *self = NULL;
-  self = (struct load_balancer_arguments *)args;
+  atomic_fetch_add(&self->moved_out[from], n);
+  atomic_fetch_add(&self->moved_in[to], n);
+}
+
+/**
+ * @note Stolen items leave the distribution of the victim and join the
+ *        one of the thief. The thief publishes the move before it acks,
+ *        so folding the moves in after the acks were read and before they
+ *        are applied never lets a count underflow.
+ */
+static void load_balancer_reconcile(load_balancer_t *self, const uint64_t k)
+{
+  uint64_t n;
 
-  self->self->distribution[self->self->i] += 1UL;
-  self->self->i = (1UL + self->self->i) % self->self->cap;
+  if (0UL != (n = atomic_exchange(&self->moved_in[k], 0UL)))
+  {
+    load_balancer_delivered(self, k, n);
+  }
 
-  return NULL;
+  if (0UL != (n = atomic_exchange(&self->moved_out[k], 0UL)))
+  {
+    load_balancer_acked(self, k, n);
+  }
 }
 
-struct load_balancer_dequeue_arguments
+struct load_balancer_arguments
 {
   load_balancer_t *self;
-  int k;
-  int *output;
+  observable_t *observable;
 };
 
-void *on_nodefect_3(worker_command_t *cmd, void *args)
+/**
+ * @note A retried write that went through counts as delivered, a retried
+ *       read of an upstream channel carries an ack.
+ */
+static void load_balancer_retried(const retry_record_t *record, const int failure,
+  void *result, void *args)
 {
   if (args == NULL)
   {
@@ -163,195 +198,464 @@ void *on_nodefect_3(worker_command_t *cmd, void *args)
     exit(EXIT_FAILURE);
   }
 
-  struct load_balancer_dequeue_arguments *self = NULL;
-  self = (struct load_balancer_dequeue_arguments *)args;
+  struct load_balancer_arguments *_args = NULL;
+  _args = (struct load_balancer_arguments *)args;
+
+  load_balancer_t *self = _args->self;
+  uint64_t k;
+
+  if (failure != SCHEDULER_FAILURE_NODEFECT)
+  {
+    return;
+  }
+
+  if (record->type == RETRY_TYPE_WRITE)
+  {
+    k = record->channel_id;
+
+    load_balancer_delivered(self, k, 1UL);
+    self->i = k;
+#if defined(NDEBUG)
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
+#endif/*NDEBUG*/
+    observer_release(_args->observable->observers[k]);
+    return;
+  }
+
+  if (result != NULL)
+  {
+    k = record->channel_id - self->cap;
+
+    load_balancer_reconcile(self, k);
+    load_balancer_acked(self, k, *(int *)result);
+    free(result);
+  }
+}
+
+#define LOAD_BALANCER_ACK_BATCH 64
+
+/**
+ * @note Takes every ack already sitting in the upstream channel of k under
+ *       a single acquisition. In SPSC mode an ack is the count itself,
+ *       carried in the pointer slot of the upstream ring.
+ */
+static void load_balancer_drain_acks(load_balancer_t *self, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const uint64_t k)
+{
+  void *acks[LOAD_BALANCER_ACK_BATCH];
+  uint64_t acked = 0UL;
+  size_t n;
+  size_t j;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+
+  if (channels[k]->upstream_ring != NULL)
+  {
+    while (0UL != (n = spsc_ring_pop_many(channels[k]->upstream_ring, acks, LOAD_BALANCER_ACK_BATCH)))
+    {
+      for (j = 0; j < n; j++)
+      {
+        acked += (uint64_t)(uintptr_t)acks[j];
+      }
+    }
+  }
+  else
+  {
+    while (0UL != (n = scheduler_dequeue_many(scheduler, (k + self->cap), &failure, acks, LOAD_BALANCER_ACK_BATCH)))
+    {
+      for (j = 0; j < n; j++)
+      {
+        acked += (uint64_t)*(int *)acks[j];
+        free(acks[j]);
+      }
+    }
+  }
+
+  load_balancer_reconcile(self, k);
 
-  if (self->output != NULL)
+  if (acked > 0UL)
   {
-    self->self->distribution[self->k] -= *self->output;
-    free(self->output);
-    self->output = NULL;
+    load_balancer_acked(self, k, acked);
   }
+}
 
-  return NULL;
+/**
+ * @note Flushes the retry engine once. The writes it holds may be waiting
+ *       on room that only the observers can make, and they in turn may be
+ *       waiting for their acks to be taken, so the acks are drained first.
+ */
+static size_t load_balancer_unblock(load_balancer_t *self, observable_t *observable)
+{
+  struct load_balancer_arguments args;
+
+  uint64_t k;
+
+  args.self = self;
+  args.observable = observable;
+
+  for (k = 0; k < self->cap; k++)
+  {
+    load_balancer_drain_acks(self, observable->scheduler, observable->channels, k);
+  }
+
+  return retry_flush(self->retry, &args);
 }
 
-void load_balancer_wait(load_balancer_t *self, void *observable, scheduler_t *scheduler)
+/**
+ * @note Only called with a failure worth retrying. The ring only fills up
+ *       while the scheduler is refusing everything, so flush it until
+ *       there is room.
+ */
+static void load_balancer_retry(load_balancer_t *self, observable_t *observable,
+  const int failure, const int type, const uint64_t channel_id, const void *data)
 {
-  worker_command_t *cmd = NULL;
+  while (false == retry_submit(self->retry, failure, type, channel_id, data))
+  {
+    if (0UL == load_balancer_unblock(self, observable))
+    {
+      sched_yield();
+    }
+  }
+}
+
+static bool load_balancer_failed(const int failure)
+{
+  return failure != SCHEDULER_FAILURE_NODEFECT &&
+         failure != SCHEDULER_FAILURE_SUCCESSFUL;
+}
 
+static void load_balancer_collect(load_balancer_t *self, observable_t *observable,
+  scheduler_t *scheduler, bidirectional_channel_t **channels)
+{
   struct load_balancer_arguments args;
-  struct load_balancer_dequeue_arguments args2;
 
   int *output = NULL;
   int failure = SCHEDULER_FAILURE_SUCCESSFUL;
 
-  observable_t *_observable = NULL;
-  _observable = observable;
-
-  uintptr_t  *inbound_addr = NULL;
-  uintptr_t *outbound_addr = NULL;
+  uint64_t i;
 
-  while (NULL != ( inbound_addr = queue_peek(self->outbound_queue)) ||
-         NULL != (outbound_addr = queue_peek(self->inbound_queue)))
+  for (i = 0; i < self->cap; i++)
   {
-    free(inbound_addr);
-    inbound_addr = NULL;
+    if (channels[i]->upstream_ring != NULL)
+    {
+      load_balancer_drain_acks(self, scheduler, channels, i);
+      continue;
+    }
 
-    free(outbound_addr);
-    outbound_addr = NULL;
+    output = scheduler_dequeue(scheduler, (i + self->cap),
+      &failure, SCHEDULER_STATE_SAVE);
 
-    switch (0)
+    load_balancer_reconcile(self, i);
+
+    if (output != NULL)
     {
-      case 0:
-#if defined(NDEBUG)
-        fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: blocked write");
-#endif/*NDEBUG*/
-        outbound_addr = queue_dequeue(self->outbound_queue);
-        if (outbound_addr == NULL)
-        {
-          goto next;
-        }
-        cmd = (worker_command_t *)(*(uintptr_t *)outbound_addr);
-        free(outbound_addr);
-        outbound_addr = NULL;
-
-        scheduler_enqueue(scheduler, cmd->channel_id, &failure,
-          cmd->status, cmd->parameter);
-
-        args.self = self;
-        args.k = cmd->channel_id;
-
-        scheduler_retry_enqueue(scheduler, self->outbound_queue, cmd->status,
-          cmd->channel_id, cmd->parameter, NULL, NULL, NULL,
-          NULL, &args);
-
-        if (failure == SCHEDULER_FAILURE_NODEFECT)
-        {
+      load_balancer_acked(self, i, *output);
+      free(output);
+      output = NULL;
+    }
+    else if (true == load_balancer_failed(failure))
+    {
+      load_balancer_retry(self, observable, failure, RETRY_TYPE_READ, (i + self->cap), NULL);
+    }
+  }
+
+  args.self = self;
+  args.observable = observable;
+
+  retry_flush(self->retry, &args);
+}
+
+void load_balancer_wait(load_balancer_t *self, void *observable)
+{
+  while (false == retry_empty(self->retry))
+  {
+    if (0UL == load_balancer_unblock(self, observable))
+    {
+      sched_yield();
+    }
+  }
+}
+
+static void load_balancer_send(load_balancer_t *self, observable_t *observable,
+  scheduler_t *scheduler, const uint64_t k, const void *data, int *failure)
+{
+  spsc_ring_t *ring = observable->channels[k]->downstream_ring;
+  scheduler_rejected_t rejected;
+
+  /**
+   * @note The ring is only full while the observer is behind, so wait for
+   *       it in place; that also keeps keyed items in order.
+   */
+  if (ring != NULL)
+  {
+    while (false == spsc_ring_push(ring, (void *)data))
+    {
+      load_balancer_collect(self, observable, scheduler, observable->channels);
+      sched_yield();
+    }
+
+    load_balancer_delivered(self, k, 1UL);
+    *failure = SCHEDULER_FAILURE_NODEFECT;
+    observer_release(observable->observers[k]);
+    return;
+  }
+
 #if defined(NDEBUG)
-          fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
+  fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocked write");
 #endif/*NDEBUG*/
-          observer_release(_observable->observers[cmd->channel_id]);
-        }
+  scheduler_enqueue(scheduler, k, failure,
+    SCHEDULER_STATE_SAVE, data, &rejected);
 
-next:
-      case 1:
+  if (*failure == SCHEDULER_FAILURE_NODEFECT)
+  {
+    load_balancer_delivered(self, k, 1UL);
+    self->i = k;
 #if defined(NDEBUG)
-        fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: blocked read");
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
 #endif/*NDEBUG*/
-        inbound_addr = queue_dequeue(self->inbound_queue);
-        if (inbound_addr == NULL)
-        {
-          break;
-        }
-        cmd = (worker_command_t *)(*(uintptr_t *)inbound_addr);
-        free(inbound_addr);
-        inbound_addr = NULL;
-
-        output = scheduler_dequeue(scheduler, cmd->channel_id,
-          &failure, cmd->status);
-
-        args2.self = self;
-        args2.k = cmd->channel_id;
-        args2.output = output;
-
-        scheduler_retry_enqueue(scheduler, self->inbound_queue,
-          failure, cmd->channel_id, NULL, NULL, NULL, &on_nodefect_3,
-          NULL, &args2);
-
-      default: break;
+    observer_release(observable->observers[k]);
+  }
+  else if (*failure == SCHEDULER_FAILURE_REJECTED)
+  {
+    /**
+     * @note The write that came back is saved anew, the one just saved is
+     *       still queued if it was not the one rejected. A full channel
+     *       means its observer has work, so make sure it is awake.
+     */
+    if (rejected.channel_id < self->cap)
+    {
+      observer_release(observable->observers[rejected.channel_id]);
     }
+
+    load_balancer_retry(self, observable, *failure, RETRY_TYPE_WRITE,
+      rejected.channel_id, rejected.data);
+  }
+  else if (true == load_balancer_failed(*failure))
+  {
+    load_balancer_retry(self, observable, *failure, RETRY_TYPE_WRITE, k, data);
   }
 }
 
 bool load_balancer_publish(load_balancer_t *self, void *observable, scheduler_t *scheduler,
   bidirectional_channel_t **channels, const void *data)
 {
-  worker_command_t *cmd = NULL;
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
 
-  int *output = NULL;
+  uint64_t k;
+
+  k = self->strategy->select(self, self->state, self->sequence++);
+
+  load_balancer_send(self, observable, scheduler, k, data, &failure);
+
+#if defined(NDEBUG)
+  fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocked read");
+#endif/*NDEBUG*/
+  load_balancer_collect(self, observable, scheduler, channels);
+
+  return true;
+}
+
+bool load_balancer_publish_keyed(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const uint64_t key, const void *data)
+{
   int failure = SCHEDULER_FAILURE_SUCCESSFUL;
 
-  uint64_t i;
   uint64_t k;
 
-  struct load_balancer_arguments args;
-  struct load_balancer_dequeue_arguments args2;
+  k = strategy_consistent_hash.select(self, NULL, key);
+
+  load_balancer_send(self, observable, scheduler, k, data, &failure);
+
+  if (true == load_balancer_failed(failure))
+  {
+    load_balancer_wait(self, observable);
+  }
+
+  load_balancer_collect(self, observable, scheduler, channels);
 
+  return true;
+}
+
+/**
+ * @note Falls through to the next channel while a band is full and, like
+ *       the SPSC path of load_balancer_send, waits in place when all of
+ *       them are.
+ */
+bool load_balancer_publish_priority(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const uint32_t prio, const void *data)
+{
   observable_t *_observable = NULL;
   _observable = observable;
 
-  switch (0)
+  uint64_t k;
+  uint64_t j;
+
+  if (channels[0]->bands[0] == NULL)
   {
-    case 0:
-#if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocked write");
-#endif/*NDEBUG*/
-      k = lru(self->distribution, self->cap);
+    return false;
+  }
+
+  k = self->strategy->select(self, self->state, self->sequence++);
 
-      if (self->i != k)
+  for (;;)
+  {
+    for (j = 0; j < self->cap; j++, k = (1UL + k) % self->cap)
+    {
+      if (true == channel_send_priority(channels[k], prio, data))
       {
-        scheduler_enqueue(scheduler, k, &failure,
-          SCHEDULER_STATE_SAVE, data);
+        goto done;
+      }
+    }
 
-        args.self = self;
-        args.k = k;
+    load_balancer_collect(self, observable, scheduler, channels);
+    sched_yield();
+  }
 
-        scheduler_retry_enqueue(scheduler, self->outbound_queue,
-          failure, k, data, NULL, &on_nodefect, &on_nodefect,
-          NULL, &args);
+done:
+  load_balancer_delivered(self, k, 1UL);
+  self->i = k;
+  observer_release(_observable->observers[k]);
 
-        if (failure == SCHEDULER_FAILURE_NODEFECT)
-        {
-#if defined(NDEBUG)
-          fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
-#endif/*NDEBUG*/
-          observer_release(_observable->observers[k]);
-        }
+  load_balancer_collect(self, observable, scheduler, channels);
 
-        goto next;
-      }
+  return true;
+}
 
-      scheduler_enqueue(scheduler, self->i, &failure,
-        SCHEDULER_STATE_SAVE, data);
+/**
+ * @note Starts at the channel picked by the strategy and falls through to
+ *       the next one while a record ring is full.
+ */
+void *load_balancer_reserve(load_balancer_t *self, bidirectional_channel_t **channels, const size_t len)
+{
+  void *payload = NULL;
+  uint64_t k;
+  uint64_t j;
 
-      args.self = self;
+  self->reserved = LOAD_BALANCER_RESERVED_NONE;
 
-      scheduler_retry_enqueue(scheduler, self->outbound_queue, failure,
-        self->i, data, NULL, &on_nodefect_2, &on_nodefect_2,
-        NULL, &args);
+  k = self->strategy->select(self, self->state, self->sequence++);
 
-      if (failure == SCHEDULER_FAILURE_NODEFECT)
-      {
-#if defined(NDEBUG)
-        fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
-#endif/*NDEBUG*/
-        observer_release(_observable->observers[self->i]);
-      }
+  for (j = 0; j < self->cap; j++, k = (1UL + k) % self->cap)
+  {
+    if (NULL != (payload = channel_reserve(channels[k], CHANNEL_DOWNSTREAM, len)))
+    {
+      self->reserved = k;
+      break;
+    }
+  }
+
+  return payload;
+}
+
+bool load_balancer_commit(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const size_t len)
+{
+  observable_t *_observable = NULL;
+  _observable = observable;
+
+  const uint64_t k = self->reserved;
+
+  if (k == LOAD_BALANCER_RESERVED_NONE ||
+      false == channel_commit(channels[k], CHANNEL_DOWNSTREAM, len))
+  {
+    return false;
+  }
+
+  self->reserved = LOAD_BALANCER_RESERVED_NONE;
+
+  load_balancer_delivered(self, k, 1UL);
+  self->i = k;
+  observer_release(_observable->observers[k]);
+
+  load_balancer_collect(self, observable, scheduler, channels);
+
+  return true;
+}
+
+bool load_balancer_publish_record(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const void *data, const size_t len)
+{
+  void *payload = NULL;
+
+  if (NULL == (payload = load_balancer_reserve(self, channels, len)))
+  {
+    load_balancer_collect(self, observable, scheduler, channels);
+    return false;
+  }
+
+  memcpy(payload, data, len);
+
+  return load_balancer_commit(self, observable, scheduler, channels, len);
+}
+
+bool load_balancer_publish_many(load_balancer_t *self, void *observable, scheduler_t *scheduler,
+  bidirectional_channel_t **channels, const void **items, const size_t n)
+{
+  size_t *quota = NULL;
+  size_t offset = 0UL;
+  size_t written;
+  size_t j;
+  uint64_t k;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
 
-next:
-    case 1:
+  observable_t *_observable = NULL;
+  _observable = observable;
+
+  quota = (size_t *)_calloc(self->cap, sizeof(*quota));
+
+  if (self->strategy->plan != NULL)
+  {
+    self->strategy->plan(self, self->state, quota, n);
+  }
+  else
+  {
+    for (j = 0; j < n; j++)
+    {
+      quota[self->strategy->select(self, self->state, self->sequence++)]++;
+    }
+  }
+
+  for (k = 0; k < self->cap; k++)
+  {
+    if (quota[k] == 0UL)
+    {
+      continue;
+    }
+
+    written = (channels[k]->downstream_ring != NULL)
+      ? spsc_ring_push_many(channels[k]->downstream_ring, (void *const *)&items[offset], quota[k])
+      : scheduler_enqueue_many(scheduler, k, &failure, &items[offset], quota[k]);
+
+    if (written > 0UL)
+    {
 #if defined(NDEBUG)
-      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocked read");
+      fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "publisher: unblocking the observer");
 #endif/*NDEBUG*/
-      failure = SCHEDULER_FAILURE_SUCCESSFUL;
+      load_balancer_delivered(self, k, written);
+      self->i = k;
+      observer_release(_observable->observers[k]);
+    }
 
-      for (i = 0; i < self->cap; i++)
+    /**
+     * @note Whatever did not fit in the run takes the single item path,
+     *       which owns the retry queues.
+     */
+    for (j = written; j < quota[k]; j++)
+    {
+      if (false == load_balancer_publish(self, observable, scheduler, channels, items[offset + j]))
       {
-        output = scheduler_dequeue(scheduler, (i + self->cap),
-          &failure, SCHEDULER_STATE_SAVE);
-
-        args2.self = self;
-        args2.k = i;
-        args2.output = output;
-
-        scheduler_retry_enqueue(scheduler, self->inbound_queue,
-          failure, (i + self->cap), NULL, NULL, NULL, &on_nodefect_3,
-          NULL, &args2);
+        __free(quota);
+        return false;
       }
+    }
 
-    default: break;
+    offset += quota[k];
   }
 
+  __free(quota);
+
+  load_balancer_collect(self, observable, scheduler, channels);
+
   return true;
 }
@@ -1,23 +1,44 @@
 #include "common.h"
+#include "internal/futex.h"
 #include "observable.h"
 #include "observer.h"
 #include "scheduler.h"
 
 #include <turnpike/bipartite.h>
 
+#include <immintrin.h>
 #include <stdatomic.h>
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sched.h>
+#include <time.h>
 
 #define COMMAND_QUEUE_CAPACITY       4096
 #define DATA_QUEUE_CAPACITY          4096
 #define DATA_QUEUE_SEGMENT_LENGTH    sizeof(int)
 
-observable_t *observable_new(const size_t cap, const size_t max_observers, const size_t max_threads)
+#define RECORD_RING_CAPACITY         65536
+
+#define PRIORITY_BAND_CAPACITY       1024
+
+#define SELECT_MAX_SPINS             1024
+
+observable_t *observable_new(const size_t cap, const size_t max_observers, const size_t max_threads, const int flags)
 {
+  /**
+   * @note Bands hand the publisher's pointer over as is, while the
+   *       scheduler hands out copies; a batch mixing both could not be
+   *       freed by its handler.
+   */
+  if ((flags & OBSERVABLE_FLAG_PRIORITY) && 0 == (flags & OBSERVABLE_FLAG_SPSC))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "priority bands need spsc channels");
+    exit(EXIT_FAILURE);
+  }
+
   observable_t *self = NULL;
   self = (observable_t *)_calloc(1, sizeof(*self));
   self->observers = (observer_t **)_calloc(max_observers, sizeof(*self->observers));
@@ -27,12 +48,42 @@ observable_t *observable_new(const size_t cap, const size_t max_observers, const
 
   for (i = 0; i < max_observers; i++)
   {
-    self->channels[i] = bidirectional_channel_new(cap, cap);
+    self->channels[i] = (flags & OBSERVABLE_FLAG_RECORDS)
+      ? bidirectional_channel_new_records(cap, cap, RECORD_RING_CAPACITY)
+      : bidirectional_channel_new(cap, cap);
+
+    if (flags & OBSERVABLE_FLAG_SPSC)
+    {
+      bidirectional_channel_spsc(self->channels[i],
+        (cap / DATA_QUEUE_SEGMENT_LENGTH), (cap / DATA_QUEUE_SEGMENT_LENGTH));
+    }
+
+    if (flags & OBSERVABLE_FLAG_PRIORITY)
+    {
+      bidirectional_channel_priority(self->channels[i], PRIORITY_BAND_CAPACITY);
+    }
+
+    if (flags & OBSERVABLE_FLAG_EVENTFD)
+    {
+      bidirectional_channel_eventfd(self->channels[i]);
+    }
   }
 
   self->queue = bipartite_queue_new(cap, 0);
-  self->lb = load_balancer_new(cap, max_observers);
-  self->scheduler = scheduler_new((2 * max_observers), COMMAND_QUEUE_CAPACITY, DATA_QUEUE_CAPACITY, NULL);
+  int mode = SCHEDULER_MODE_LOCKED;
+
+  if (flags & OBSERVABLE_FLAG_SHARDED)
+  {
+    mode = SCHEDULER_MODE_SHARDED;
+  }
+  else if (flags & OBSERVABLE_FLAG_LOCK_FREE)
+  {
+    mode = SCHEDULER_MODE_LOCK_FREE;
+  }
+
+  self->scheduler = scheduler_new((2 * max_observers), COMMAND_QUEUE_CAPACITY, DATA_QUEUE_CAPACITY, NULL, mode);
+  self->lb = load_balancer_new(self->scheduler, max_observers, (flags & OBSERVABLE_FLAG_TWO_CHOICES)
+    ? LOAD_BALANCER_POLICY_TWO_CHOICES : LOAD_BALANCER_POLICY_LEAST_LOADED);
 
   for (i = 0; i < max_observers; i++)
   {
@@ -46,6 +97,8 @@ observable_t *observable_new(const size_t cap, const size_t max_observers, const
 
   atomic_init(&self->done, false);
 
+  self->steal = (0 == (flags & OBSERVABLE_FLAG_NO_STEAL));
+
   self->max_observers = max_observers;
   self->max_threads = max_threads;
   self->cap = cap;
@@ -98,43 +151,122 @@ void observable_destroy(observable_t *self)
   }
 }
 
+/**
+ * @note Spins for a bounded number of pauses to keep the wake-up latency
+ *       low under load, then parks on the ready word of the observer
+ *       until observer_release or observable_shutdown wakes it.
+ */
 void observable_select(observable_t *self, observer_t *observer)
 {
   if (self == NULL)
   {
     return;
   }
+
+  unsigned int expected;
+  uint64_t spins = 0;
+
 loop:
-  if (true == atomic_load(&observer->ready) ||
+  if (OBSERVER_STATE_READY == atomic_load(&observer->ready) ||
       true == atomic_load(&self->done))
   {
     goto done;
   }
+
+  if (spins < SELECT_MAX_SPINS)
+  {
+    spins++;
+    _mm_pause();
+    goto loop;
+  }
+
+  expected = OBSERVER_STATE_IDLE;
+  if (atomic_compare_exchange_strong(&observer->ready, &expected, OBSERVER_STATE_PARKED) ||
+      expected == OBSERVER_STATE_PARKED)
+  {
+    futex_wait(&observer->ready, OBSERVER_STATE_PARKED);
+  }
   goto loop;
 done:
   return;
 }
 
-void observable_shutdown(observable_t *self)
+static int64_t observable_clock_ms(void)
 {
-  if (self == NULL)
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
   {
-    return;
+    fprintf(stderr, "%s(): %s\n", __func__, "could not read the monotonic clock");
+    exit(EXIT_FAILURE);
   }
 
-  bool expected = false;
+  return ((int64_t)ts.tv_sec * 1000L) + ((int64_t)ts.tv_nsec / 1000000L);
+}
+
+static uint64_t observable_rings_queued(observable_t *self)
+{
+  uint64_t queued = 0UL;
   uint64_t i;
 
   for (i = 0; i < self->max_observers; i++)
   {
-loop:
-    if (false == scheduler_empty(self->scheduler, i))
+    if (self->channels[i]->downstream_records != NULL)
     {
-      goto loop;
+      queued += byte_ring_size(self->channels[i]->downstream_records);
     }
+
+    if (self->channels[i]->downstream_ring != NULL)
+    {
+      queued += spsc_ring_size(self->channels[i]->downstream_ring);
+    }
+
+    queued += channel_priority_size(self->channels[i]);
+  }
+
+  return queued;
+}
+
+uint64_t observable_shutdown(observable_t *self, const long timeout_ms)
+{
+  if (self == NULL)
+  {
+    return 0UL;
+  }
+
+  bool expected = false;
+  uint64_t queued;
+  uint64_t i;
+
+  const int64_t deadline = observable_clock_ms() + timeout_ms;
+
+  queued = scheduler_drain(self->scheduler, self->max_observers, timeout_ms);
+
+  /**
+   * @note Record, SPSC and priority rings bypass the scheduler and have nobody to
+   *       wake us, so they are polled.
+   */
+  while (0UL != observable_rings_queued(self) &&
+         (timeout_ms < 0 || observable_clock_ms() < deadline))
+  {
+    sched_yield();
+  }
+
+  queued += observable_rings_queued(self);
+
+  if (queued > 0UL)
+  {
+    fprintf(stderr, "%s(): %lu %s\n", __func__, queued, "items were still queued");
   }
 
   atomic_compare_exchange_strong(&self->done, &expected, true);
+
+  for (i = 0; i < self->count; i++)
+  {
+    observer_release(self->observers[i]);
+  }
+
+  return queued;
 }
 
 bool observable_cleanup(observable_t *self)
@@ -144,7 +276,7 @@ bool observable_cleanup(observable_t *self)
     return false;
   }
 
-  load_balancer_wait(self->lb, self, self->scheduler);
+  load_balancer_wait(self->lb, self);
 
   return true;
 }
@@ -165,6 +297,78 @@ bool observable_publish(observable_t *self, const void *data)
   return true;
 }
 
+bool observable_publish_keyed(observable_t *self, const uint64_t key, const void *data)
+{
+  if (self == NULL)
+  {
+    return false;
+  }
+
+  if (false == load_balancer_publish_keyed(self->lb, self, self->scheduler, self->channels, key, data))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue item");
+    return false;
+  }
+
+  return true;
+}
+
+bool observable_publish_priority(observable_t *self, const uint32_t prio, const void *data)
+{
+  if (self == NULL)
+  {
+    return false;
+  }
+
+  return load_balancer_publish_priority(self->lb, self, self->scheduler, self->channels, prio, data);
+}
+
+bool observable_publish_record(observable_t *self, const void *data, const size_t len)
+{
+  if (self == NULL || data == NULL)
+  {
+    return false;
+  }
+
+  return load_balancer_publish_record(self->lb, self, self->scheduler, self->channels, data, len);
+}
+
+void *observable_reserve(observable_t *self, const size_t len)
+{
+  if (self == NULL)
+  {
+    return NULL;
+  }
+
+  return load_balancer_reserve(self->lb, self->channels, len);
+}
+
+bool observable_commit(observable_t *self, const size_t len)
+{
+  if (self == NULL)
+  {
+    return false;
+  }
+
+  return load_balancer_commit(self->lb, self, self->scheduler, self->channels, len);
+}
+
+bool observable_publish_many(observable_t *self, const void **items, const size_t n)
+{
+  if (self == NULL || items == NULL)
+  {
+    return false;
+  }
+
+  if (false == load_balancer_publish_many(self->lb, self, self->scheduler, self->channels, items, n))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue items");
+    return false;
+  }
+
+  return true;
+}
+
 bool observable_subscribe(observable_t *self, observer_t *observer)
 {
   if (self == NULL || observer == NULL)
@@ -177,6 +381,7 @@ bool observable_subscribe(observable_t *self, observer_t *observer)
     return false;
   }
 
+  load_balancer_join(self->lb, self->count);
   self->observers[self->count++] = observer;
 
   return true;
@@ -1,16 +1,23 @@
 #include "common.h"
+#include "internal/futex.h"
+#include "observable.h"
 #include "observer.h"
+#include "scheduler.h"
 
+#include <immintrin.h>
+#include <sched.h>
 #include <stdatomic.h>
 #include <stddef.h>
 #include <stdlib.h>
 
+#define OBSERVER_MAX_SPINS 64
+
 observer_t *observer_new(struct observable *observable, bidirectional_channel_t *channel, observer_callback_t notify, const uint64_t channel_id)
 {
   observer_t *self = NULL;
   self = (observer_t *)_calloc(1, sizeof(*self));
 
-  atomic_init(&self->ready, false);
+  atomic_init(&self->ready, OBSERVER_STATE_IDLE);
 
   self->observable = observable;
   self->channel = channel;
@@ -36,8 +43,17 @@ void observer_release(observer_t *self)
     exit(EXIT_FAILURE);
   }
 
-  const bool expected = false;
-  atomic_compare_exchange_strong(&self->ready, &expected, true);
+  const unsigned int state = atomic_exchange(&self->ready, OBSERVER_STATE_READY);
+
+  if (state == OBSERVER_STATE_PARKED)
+  {
+    futex_wake(&self->ready, 1);
+  }
+
+  if (state != OBSERVER_STATE_READY)
+  {
+    channel_notify(self->channel);
+  }
 }
 
 void observer_clear(observer_t *self)
@@ -48,6 +64,298 @@ void observer_clear(observer_t *self)
     exit(EXIT_FAILURE);
   }
 
-  const bool expected = true;
-  atomic_compare_exchange_strong(&self->ready, &expected, false);
+  unsigned int expected = OBSERVER_STATE_READY;
+  atomic_compare_exchange_strong(&self->ready, &expected, OBSERVER_STATE_IDLE);
+}
+
+int observer_fd(observer_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return self->channel->eventfd;
+}
+
+void observer_rearm(observer_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  channel_rearm(self->channel);
+  observer_clear(self);
+}
+
+size_t observer_receive_batch(observer_t *self, void **out, const size_t max, int *failure)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (out == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "output buffer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (failure == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "failure state pointer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  size_t n;
+
+  n = channel_receive_priority(self->channel, out, max);
+
+  if (n < max && self->channel->downstream_ring != NULL)
+  {
+    n += spsc_ring_pop_many(self->channel->downstream_ring, &out[n], max - n);
+  }
+  else if (n < max)
+  {
+    return n + scheduler_dequeue_many(self->observable->scheduler,
+      self->channel_id, failure, &out[n], max - n);
+  }
+
+  *failure = (n > 0UL)
+    ? SCHEDULER_FAILURE_NODEFECT
+    : SCHEDULER_FAILURE_SUCCESSFUL;
+
+  return n;
+}
+
+bool observer_ack(observer_t *self, const int n)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+  const void *value = &n;
+
+  if (self->channel->upstream_ring != NULL)
+  {
+    return spsc_ring_push(self->channel->upstream_ring, (void *)(uintptr_t)n);
+  }
+
+  return 1UL == scheduler_enqueue_many(self->observable->scheduler,
+    (self->channel_id + self->observable->max_observers), &failure, &value, 1UL);
+}
+
+/**
+ * @note Every record counts as one item on the channel, so it is
+ *       acknowledged like one. An ack that finds the upstream side busy or
+ *       full is carried over instead of waited for: the publisher may be
+ *       done publishing and no longer collecting, and a consumer spinning
+ *       here would then never drain the rest of its ring.
+ */
+static void observer_ack_records(observer_t *self, const int n)
+{
+  self->unacked += n;
+
+  if (self->unacked > 0 && true == observer_ack(self, self->unacked))
+  {
+    self->unacked = 0;
+  }
+}
+
+bool observer_receive_record(observer_t *self, void *out, size_t *len)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const bool received = channel_receive(self->channel, CHANNEL_DOWNSTREAM, out, len);
+
+  observer_ack_records(self, (received) ? 1 : 0);
+
+  return received;
+}
+
+const void *observer_peek_record(observer_t *self, size_t *len)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  const void *record = channel_peek(self->channel, CHANNEL_DOWNSTREAM, len);
+
+  if (record == NULL)
+  {
+    observer_ack_records(self, 0);
+  }
+
+  return record;
+}
+
+void observer_release_record(observer_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  channel_release(self->channel, CHANNEL_DOWNSTREAM);
+  observer_ack_records(self, 1);
+}
+
+size_t observer_steal(observer_t *self, void **out, const size_t max)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (out == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "output buffer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  observable_t *observable = self->observable;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+  uint64_t victim = self->channel_id;
+  uint64_t deepest = 0UL;
+  uint64_t depth;
+  size_t want;
+  size_t n;
+  uint64_t i;
+
+  if (self->channel->downstream_ring != NULL || false == observable->steal)
+  {
+    return 0UL;
+  }
+
+  for (i = 0; i < observable->count; i++)
+  {
+    if (i == self->channel_id)
+    {
+      continue;
+    }
+
+    depth = scheduler_depth(observable->scheduler, i);
+
+    if (depth > deepest)
+    {
+      deepest = depth;
+      victim = i;
+    }
+  }
+
+  if (deepest == 0UL)
+  {
+    return 0UL;
+  }
+
+  want = (deepest + 1UL) / 2UL;
+
+  if (want > max)
+  {
+    want = max;
+  }
+
+  n = scheduler_dequeue_many(observable->scheduler, victim, &failure, out, want);
+
+  if (n > 0UL)
+  {
+    load_balancer_moved(observable->lb, victim, self->channel_id, n);
+  }
+
+  return n;
+}
+
+static void observer_backoff(const uint64_t spins)
+{
+  if (spins < OBSERVER_MAX_SPINS)
+  {
+    _mm_pause();
+  }
+  else
+  {
+    sched_yield();
+  }
+}
+
+/**
+ * @note The ready word is cleared before the channel is looked at, so an
+ *       item published after an empty receive leaves it set and the select
+ *       that follows returns at once instead of parking. Only a receive
+ *       that found the channel empty may lead to parking: in locked mode a
+ *       busy semaphore also yields nothing, and parking then would leave
+ *       the observer asleep on a channel that is full.
+ */
+void observer_run(observer_t *self, observer_handler_t handler)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "observer instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (handler == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "handler may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  void *items[OBSERVER_RUN_BATCH];
+  uint64_t busy = 0UL;
+  uint64_t spins;
+  size_t n;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+
+  while (false == atomic_load(&self->observable->done))
+  {
+    n = observer_receive_batch(self, items, OBSERVER_RUN_BATCH, &failure);
+
+    if (n == 0UL && failure != SCHEDULER_FAILURE_SUCCESSFUL)
+    {
+      observer_backoff(busy++);
+      continue;
+    }
+
+    busy = 0UL;
+
+    if (n == 0UL)
+    {
+      n = observer_steal(self, items, OBSERVER_RUN_BATCH);
+    }
+
+    if (n == 0UL)
+    {
+      observable_select(self->observable, self);
+      observer_clear(self);
+      continue;
+    }
+
+    handler(self, items, n);
+
+    /**
+     * @note The upstream side is only busy for the length of one command
+     *       or full until the publisher next collects, so wait for it
+     *       without sleeping.
+     */
+    for (spins = 0UL; false == observer_ack(self, (int)n); spins++)
+    {
+      observer_backoff(spins);
+    }
+  }
 }
@@ -0,0 +1,329 @@
+#include "common.h"
+#include "retry.h"
+#include "scheduler.h"
+
+#include <inttypes.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+retry_t *retry_new(scheduler_t *scheduler, retry_callback_t callback)
+{
+  if (scheduler == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  retry_t *self = NULL;
+  self = (retry_t *)_calloc(1, sizeof(*self));
+
+  retry_ring_init(&self->ring);
+
+  self->scheduler = scheduler;
+  self->callback = callback;
+  self->seed = (uint64_t)(uintptr_t)self | 1UL;
+
+  return self;
+}
+
+void retry_destroy(retry_t *self)
+{
+  if (self != NULL)
+  {
+    __free(self);
+  }
+}
+
+static int64_t retry_clock_ns(void)
+{
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not read the monotonic clock");
+    exit(EXIT_FAILURE);
+  }
+
+  return ((int64_t)ts.tv_sec * 1000000000L) + (int64_t)ts.tv_nsec;
+}
+
+/**
+ * @note Exponential in the number of attempts and capped, then jittered
+ *       over its upper half so that retries of several threads do not
+ *       hit the scheduler in lockstep.
+ */
+static int64_t retry_backoff(retry_t *self, const uint32_t attempts)
+{
+  int64_t delay = RETRY_BACKOFF_MAX_NS;
+
+  if (attempts < 10U)
+  {
+    delay = RETRY_BACKOFF_MIN_NS << attempts;
+    delay = (delay < RETRY_BACKOFF_MAX_NS) ? delay : RETRY_BACKOFF_MAX_NS;
+  }
+
+  self->seed ^= self->seed << 13;
+  self->seed ^= self->seed >> 7;
+  self->seed ^= self->seed << 17;
+
+  return (delay / 2L) + (int64_t)(self->seed % (uint64_t)(delay / 2L + 1L));
+}
+
+bool retry_submit(retry_t *self, const int failure, const int type,
+  const uint64_t channel_id, const void *data)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "retry instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  retry_record_t record;
+
+  /**
+   * @note A rejected write already left the command queue, so running it
+   *       again means saving its payload anew, not executing.
+   */
+  switch (failure)
+  {
+    case SCHEDULER_FAILURE_SAVE:
+    case SCHEDULER_FAILURE_REJECTED:
+      record.state = SCHEDULER_STATE_SAVE;
+      break;
+
+    case SCHEDULER_FAILURE_EXECUTE:
+    case SCHEDULER_FAILURE_EARLY_RELEASE:
+      record.state = SCHEDULER_STATE_EXECUTE;
+      break;
+
+    default:
+      return false;
+  }
+
+  record.channel_id = channel_id;
+  record.data = data;
+  record.not_before = 0L;
+  record.attempts = 0U;
+  record.type = type;
+
+  return retry_ring_push(&self->ring, record);
+}
+
+static void retry_complete(retry_t *self, const retry_record_t *record, const int failure,
+  void *result, void *args)
+{
+  if (self->callback != NULL)
+  {
+    self->callback(record, failure, result, args);
+  }
+}
+
+static void retry_defer(retry_t *self, retry_record_t *record, const int failure, const int64_t now)
+{
+  if (failure == SCHEDULER_FAILURE_SAVE)
+  {
+    record->state = SCHEDULER_STATE_SAVE;
+  }
+  else
+  {
+    record->state = SCHEDULER_STATE_EXECUTE;
+  }
+
+  record->not_before = now + retry_backoff(self, record->attempts);
+  record->attempts++;
+
+  /**
+   * @note Never fails, the record was popped from the same ring.
+   */
+  retry_ring_push(&self->ring, *record);
+}
+
+static bool retry_failed(const int failure)
+{
+  return failure != SCHEDULER_FAILURE_NODEFECT &&
+         failure != SCHEDULER_FAILURE_SUCCESSFUL;
+}
+
+/**
+ * @note Writes still in the save state never made it into a command ring,
+ *       so a run of them to the same channel can be written straight into
+ *       the target under a single acquisition of the scheduler. Whatever
+ *       does not fit stays in the save state.
+ */
+static size_t retry_write_many(retry_t *self, retry_record_t *records, bool *done,
+  const size_t at, const size_t n, const int64_t now, void *args)
+{
+  const void *data[RETRY_BATCH];
+  size_t index[RETRY_BATCH];
+  size_t count = 0UL;
+  size_t written;
+  size_t j;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+
+  const uint64_t channel_id = records[at].channel_id;
+
+  for (j = at; j < n; j++)
+  {
+    if (false == done[j] &&
+        records[j].type == RETRY_TYPE_WRITE &&
+        records[j].state == SCHEDULER_STATE_SAVE &&
+        records[j].channel_id == channel_id &&
+        records[j].not_before <= now)
+    {
+      data[count] = records[j].data;
+      index[count] = j;
+      count++;
+    }
+  }
+
+  written = scheduler_enqueue_many(self->scheduler, channel_id, &failure, data, count);
+
+  for (j = 0; j < count; j++)
+  {
+    done[index[j]] = true;
+
+    if (j < written)
+    {
+      retry_complete(self, &records[index[j]], SCHEDULER_FAILURE_NODEFECT, NULL, args);
+    }
+    else
+    {
+      retry_defer(self, &records[index[j]], SCHEDULER_FAILURE_SAVE, now);
+    }
+  }
+
+  return written;
+}
+
+size_t retry_flush(retry_t *self, void *args)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "retry instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  retry_record_t records[RETRY_BATCH];
+  bool done[RETRY_BATCH];
+
+  size_t pending = retry_ring_size(&self->ring);
+  size_t completed = 0UL;
+  size_t n;
+  size_t j;
+
+  int failure = SCHEDULER_FAILURE_SUCCESSFUL;
+  void *result = NULL;
+
+  scheduler_rejected_t rejected;
+  int64_t now;
+
+  if (pending == 0UL)
+  {
+    return 0UL;
+  }
+
+  now = retry_clock_ns();
+
+  /**
+   * @note Only the records present on entry are looked at, the ones that
+   *       fail again are pushed behind them.
+   */
+  while (pending > 0UL)
+  {
+    n = retry_ring_pop_many(&self->ring, records, (pending < RETRY_BATCH) ? pending : RETRY_BATCH);
+    pending -= n;
+
+    for (j = 0; j < n; j++)
+    {
+      done[j] = false;
+    }
+
+    for (j = 0; j < n; j++)
+    {
+      if (true == done[j])
+      {
+        continue;
+      }
+
+      if (records[j].not_before > now)
+      {
+        done[j] = true;
+        retry_ring_push(&self->ring, records[j]);
+        continue;
+      }
+
+      if (records[j].type == RETRY_TYPE_WRITE && records[j].state == SCHEDULER_STATE_SAVE)
+      {
+        completed += retry_write_many(self, records, done, j, n, now, args);
+        continue;
+      }
+
+      done[j] = true;
+
+      if (records[j].type == RETRY_TYPE_WRITE)
+      {
+        scheduler_enqueue(self->scheduler, records[j].channel_id, &failure,
+          records[j].state, records[j].data, &rejected);
+        result = NULL;
+
+        if (failure == SCHEDULER_FAILURE_REJECTED)
+        {
+          records[j].channel_id = rejected.channel_id;
+          records[j].data = rejected.data;
+          retry_defer(self, &records[j], SCHEDULER_FAILURE_SAVE, now);
+          continue;
+        }
+      }
+      else
+      {
+        result = scheduler_dequeue(self->scheduler, records[j].channel_id, &failure,
+          records[j].state);
+      }
+
+      if (true == retry_failed(failure))
+      {
+        retry_defer(self, &records[j], failure, now);
+        continue;
+      }
+
+      retry_complete(self, &records[j], failure, result, args);
+      completed++;
+    }
+  }
+
+  return completed;
+}
+
+void retry_drain(retry_t *self, void *args)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "retry instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  while (false == retry_ring_empty(&self->ring))
+  {
+    if (0UL == retry_flush(self, args))
+    {
+      sched_yield();
+    }
+  }
+}
+
+bool retry_empty(retry_t *self)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "retry instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  return retry_ring_empty(&self->ring);
+}
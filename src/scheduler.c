@@ -1,16 +1,24 @@
 #include "common.h"
 #include "internal/command.h"
+#include "internal/futex.h"
+#include "internal/mpmc_ring.h"
 #include "scheduler.h"
 
+#include <immintrin.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <semaphore.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #define SCHEDULER_COMMAND_PROBE_TRUE  true
 #define SCHEDULER_COMMAND_PROBE_FALSE false
 
+#define SCHEDULER_BUDGET_MIN          8UL
+
 enum
 {
   SCHEDULER_STATUS_INITIALIZED,
@@ -18,33 +26,81 @@ enum
   SCHEDULER_STATUS_COMPLETED,
   SCHEDULER_STATUS_NODEFECT,
   SCHEDULER_STATUS_EARLY_RELEASE,
+  SCHEDULER_STATUS_REJECTED,
 };
 
 static const command_callback_t command_writer = &command_write;
 static const command_callback_t command_reader = &command_read;
+static const command_callback_t command_batch_writer = &command_write_many;
+static const command_callback_t command_batch_reader = &command_read_many;
 
 scheduler_t *scheduler_new(const size_t max_targets, const size_t max_jobs,
-  const size_t max_data, bipartite_queue_t *target)
+  const size_t max_data, bipartite_queue_t *target, const int mode)
 {
   scheduler_t *self = NULL;
   self = (scheduler_t *)_calloc(1, sizeof(*self));
 
-  self->inbound  = bipartite_queue_new(max_jobs * sizeof(command_t *), sizeof(command_t *));
-  self->outbound = bipartite_queue_new(max_jobs * sizeof(command_t *), sizeof(command_t *));
+  uint64_t i;
+
+  self->shards = (scheduler_shard_t *)_calloc(max_targets, sizeof(*self->shards));
+
+  for (i = 0; i < max_targets; i++)
+  {
+    atomic_init(&self->shards[i].depth, 0UL);
+    atomic_flag_clear(&self->shards[i].busy);
+  }
+
+  switch (mode)
+  {
+    case SCHEDULER_MODE_LOCK_FREE:
+    case SCHEDULER_MODE_SHARDED:
+      for (i = 0; i < max_targets; i++)
+      {
+        if (i == 0 || mode == SCHEDULER_MODE_SHARDED)
+        {
+          self->shards[i].inbound  = mpmc_ring_new(max_jobs);
+          self->shards[i].outbound = mpmc_ring_new(max_jobs);
+        }
+        else
+        {
+          self->shards[i].inbound  = self->shards[0].inbound;
+          self->shards[i].outbound = self->shards[0].outbound;
+        }
+      }
+      break;
+
+    case SCHEDULER_MODE_LOCKED:
+      self->inbound  = bipartite_queue_new(max_jobs * sizeof(command_t *), sizeof(command_t *));
+      self->outbound = bipartite_queue_new(max_jobs * sizeof(command_t *), sizeof(command_t *));
+      break;
+
+    default:
+      fprintf(stderr, "%s(): %s\n", __func__, "unknown scheduler mode");
+      exit(EXIT_FAILURE);
+  }
 
   self->targets = (bipartite_queue_t **)_calloc(max_targets, sizeof(*self->targets));
+  self->pool = command_pool_new(2UL * max_jobs);
 
   if (sem_init(&self->lock, 0, 1) < 0)
   {
-    fprintf(stderr, "%s(): %s\n", "scheduler could not init semaphore");
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler could not init semaphore");
     exit(EXIT_FAILURE);
   }
 
+  atomic_init(&self->counter, 0UL);
+  atomic_init(&self->drained, 0U);
+  atomic_init(&self->drain_waiters, 0U);
+
+  self->mode = mode;
   self->target_count = 0UL;
   self->max_targets = max_targets;
-  self->mcop = (size_t)((double)0.1 * max_jobs) / 2UL;
   self->max_jobs = max_jobs;
 
+  atomic_init(&self->waiters, 0UL);
+  self->w_budget = SCHEDULER_BUDGET_MIN;
+  self->r_budget = SCHEDULER_BUDGET_MIN;
+
   return self;
 }
 
@@ -62,6 +118,27 @@ void scheduler_destroy(scheduler_t *self)
       bipartite_queue_destroy(self->outbound);
     }
 
+    if (self->shards != NULL)
+    {
+      uint64_t i;
+
+      for (i = 0; i < self->max_targets; i++)
+      {
+        if (i == 0 || self->mode == SCHEDULER_MODE_SHARDED)
+        {
+          mpmc_ring_destroy(self->shards[i].inbound);
+          mpmc_ring_destroy(self->shards[i].outbound);
+        }
+      }
+
+      __free(self->shards);
+    }
+
+    if (self->pool != NULL)
+    {
+      command_pool_destroy(self->pool);
+    }
+
     __free(self->targets);
 
     free(self);
@@ -69,7 +146,194 @@ void scheduler_destroy(scheduler_t *self)
   }
 }
 
-static void *scheduler_execute(scheduler_t *self, const int type, int *status)
+static void scheduler_claim(scheduler_t *self, const uint64_t i)
+{
+  while (atomic_flag_test_and_set_explicit(&self->shards[i].busy, memory_order_acquire))
+  {
+    _mm_pause();
+  }
+}
+
+static void scheduler_unclaim(scheduler_t *self, const uint64_t i)
+{
+  atomic_flag_clear_explicit(&self->shards[i].busy, memory_order_release);
+}
+
+/**
+ * @note Both are called while target i is held, so a decrement can never
+ *       overtake the increment of the item it consumes.
+ */
+static void scheduler_produced(scheduler_t *self, const uint64_t i, const uint64_t n)
+{
+  atomic_fetch_add_explicit(&self->shards[i].depth, n, memory_order_relaxed);
+}
+
+static void scheduler_consumed(scheduler_t *self, const uint64_t i, const uint64_t n)
+{
+  if (n == 0UL)
+  {
+    return;
+  }
+
+  if (n == atomic_fetch_sub(&self->shards[i].depth, n))
+  {
+    atomic_fetch_add(&self->drained, 1U);
+
+    if (0U < atomic_load(&self->drain_waiters))
+    {
+      futex_wake(&self->drained, INT_MAX);
+    }
+  }
+}
+
+/**
+ * @note Every failed attempt on the semaphore is a thread that wanted in
+ *       while somebody else held it, which is what the early release
+ *       budget is driven by.
+ */
+static bool scheduler_trylock(scheduler_t *self)
+{
+  if (sem_trywait(&self->lock) < 0)
+  {
+    atomic_fetch_add_explicit(&self->waiters, 1UL, memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @note Called under the semaphore once per write or read. Once the holder
+ *       has used up its budget it only releases early if somebody failed
+ *       to get the semaphore in the meantime, and the budget is halved
+ *       when the other direction also has commands piling up. Without
+ *       contention the budget doubles, up to max_jobs, so a lone producer
+ *       or consumer is never bounced back to its retry queue for nothing.
+ */
+static bool scheduler_early_release(scheduler_t *self, uint64_t *burst, uint64_t *budget,
+  bipartite_queue_t *opposite)
+{
+  if (++(*burst) < *budget)
+  {
+    return false;
+  }
+
+  *burst = 0UL;
+
+  if (0UL == atomic_exchange_explicit(&self->waiters, 0UL, memory_order_relaxed))
+  {
+    *budget = (2UL * *budget < self->max_jobs) ? (2UL * *budget) : self->max_jobs;
+    return false;
+  }
+
+  if (false == bipartite_queue_empty(opposite))
+  {
+    *budget = (*budget / 2UL > SCHEDULER_BUDGET_MIN) ? (*budget / 2UL) : SCHEDULER_BUDGET_MIN;
+  }
+
+  return true;
+}
+
+/**
+ * @note A write whose target is full has already left the command queue,
+ *       so its payload is handed back instead of being dropped with the
+ *       command.
+ */
+static void scheduler_reject(scheduler_t *self, command_t *cmd, scheduler_rejected_t *rejected, int *status)
+{
+  rejected->channel_id = cmd->channel_id;
+  rejected->data = cmd->parameter;
+
+  command_pool_release(self->pool, cmd);
+  *status = SCHEDULER_STATUS_REJECTED;
+}
+
+/**
+ * @note There is no process-wide token to hand back in lock-free mode,
+ *       so early release never applies. Two commands only wait on each
+ *       other when they target the same queue. In sharded mode the
+ *       shard of target i only ever holds commands for target i.
+ */
+static void *scheduler_execute_lock_free(scheduler_t *self, const int type,
+  const uint64_t i, int *status, scheduler_rejected_t *rejected)
+{
+  command_t *cmd = NULL;
+  void *result = NULL;
+  bipartite_queue_t *target = NULL;
+  mpmc_ring_t *ring = NULL;
+
+  switch (type)
+  {
+    case COMMAND_TYPE_WRITE:
+      ring = self->shards[i].inbound;
+      break;
+
+    case COMMAND_TYPE_READ:
+      ring = self->shards[i].outbound;
+      break;
+
+    default:
+      fprintf(stderr, "%s(): %s\n", __func__, "unknown command type");
+      return NULL;
+  }
+
+  cmd = (command_t *)mpmc_ring_dequeue(ring);
+  if (cmd == NULL)
+  {
+#if defined(NDEBUG)
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: completed");
+#endif/*NDEBUG*/
+    *status = SCHEDULER_STATUS_COMPLETED;
+    return NULL;
+  }
+
+  target = scheduler_get(self, cmd->channel_id);
+  if (target == NULL)
+  {
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: null target queue");
+    exit(EXIT_FAILURE);
+  }
+
+  scheduler_claim(self, cmd->channel_id);
+  result = cmd->callback(cmd, target, SCHEDULER_COMMAND_PROBE_FALSE);
+  if (type == COMMAND_TYPE_WRITE && COMMAND_RESULT_SUCCESS == cmd->result)
+  {
+    scheduler_produced(self, cmd->channel_id, 1UL);
+  }
+  else if (type == COMMAND_TYPE_READ && result != NULL)
+  {
+    scheduler_consumed(self, cmd->channel_id, 1UL);
+  }
+  scheduler_unclaim(self, cmd->channel_id);
+
+  *status = SCHEDULER_STATUS_NODEFECT;
+
+  if (type == COMMAND_TYPE_WRITE)
+  {
+    if (COMMAND_RESULT_SUCCESS != cmd->result)
+    {
+      scheduler_reject(self, cmd, rejected, status);
+      return NULL;
+    }
+
+    self->counter++;
+  }
+  else
+  {
+    self->counter--;
+  }
+
+  command_pool_release(self->pool, cmd);
+  cmd = NULL;
+
+#if defined(NDEBUG)
+  fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: no defect");
+#endif/*NDEBUG*/
+  return result;
+}
+
+static void *scheduler_execute(scheduler_t *self, const int type,
+  const uint64_t i, int *status, scheduler_rejected_t *rejected)
 {
   if (self == NULL)
   {
@@ -83,7 +347,6 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
     exit(EXIT_FAILURE);
   }
 
-  command_callback_t fn = NULL;
   command_t *cmd = NULL;
   uintptr_t *addr = NULL;
   void *result = NULL;
@@ -91,7 +354,12 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
 
   *status = SCHEDULER_STATUS_INITIALIZED;
 
-  if (sem_trywait(&self->lock) < 0)
+  if (self->mode != SCHEDULER_MODE_LOCKED)
+  {
+    return scheduler_execute_lock_free(self, type, i, status, rejected);
+  }
+
+  if (false == scheduler_trylock(self))
   {
 #if defined(NDEBUG)
     fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: cannot acquire the lock");
@@ -107,9 +375,7 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
       fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: attempting write");
 #endif/*NDEBUG*/
 
-      self->w_exec = (1UL + self->w_exec) % self->mcop;
-      if (0UL == ((1UL + self->w_sched) % (self->mcop - 1UL)) ||
-          0UL == self->w_exec)
+      if (scheduler_early_release(self, &self->w_burst, &self->w_budget, self->outbound))
       {
 #if defined(NDEBUG)
         fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: early release");
@@ -139,6 +405,13 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
       addr = (uintptr_t *)bipartite_queue_dequeue(self->inbound);
       free(addr);
       addr = NULL;
+      if (COMMAND_RESULT_SUCCESS != cmd->result)
+      {
+        scheduler_reject(self, cmd, rejected, status);
+        break;
+      }
+      scheduler_produced(self, cmd->channel_id, 1UL);
+      command_pool_release(self->pool, cmd);
 #if defined(NDEBUG)
       fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: no defect");
 #endif/*NDEBUG*/
@@ -151,10 +424,11 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
       fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: attempting read");
 #endif/*NDEBUG*/
 
-      self->r_exec = (1UL + self->r_exec) % self->mcop;
-      if (0UL == ((1UL + self->r_sched) % (self->mcop - 1UL)) ||
-          0UL == self->r_exec)
+      if (scheduler_early_release(self, &self->r_burst, &self->r_budget, self->inbound))
       {
+#if defined(NDEBUG)
+        fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: early release");
+#endif/*NDEBUG*/
         *status = SCHEDULER_STATUS_EARLY_RELEASE;
         break;
       }
@@ -191,6 +465,11 @@ static void *scheduler_execute(scheduler_t *self, const int type, int *status)
       free(addr);
       addr = NULL;
       result = cmd->callback(cmd, target, SCHEDULER_COMMAND_PROBE_FALSE);
+      if (result != NULL)
+      {
+        scheduler_consumed(self, cmd->channel_id, 1UL);
+      }
+      command_pool_release(self->pool, cmd);
 #if defined(NDEBUG)
       fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: no defect");
 #endif/*NDEBUG*/
@@ -213,7 +492,8 @@ exit:
   return result;
 }
 
-bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const int state, const void *data)
+bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const int state, const void *data,
+  scheduler_rejected_t *rejected)
 {
   if (self == NULL)
   {
@@ -227,23 +507,45 @@ bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const
     exit(EXIT_FAILURE);
   }
 
+  if (rejected == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "rejected write pointer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
   command_t *command = NULL;
-  void *retval = NULL;
 
   bool result = false;
   int status = SCHEDULER_STATUS_INITIALIZED;
 
-  command = command_new(COMMAND_STATUS_UNSCHEDULED, i, command_writer, data);
-
   switch (state)
   {
     case SCHEDULER_STATE_SAVE:
-      if (sem_trywait(&self->lock) < 0)
+      command = command_pool_acquire(self->pool, COMMAND_STATUS_UNSCHEDULED, i, command_writer, data);
+
+      if (self->mode != SCHEDULER_MODE_LOCKED)
+      {
+        command->status = COMMAND_STATUS_SCHEDULED;
+        if (false == mpmc_ring_enqueue(self->shards[i].inbound, command))
+        {
+#if defined(NDEBUG)
+          fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: inbound ring exception");
+#endif/*NDEBUG*/
+          command_pool_release(self->pool, command);
+          command = NULL;
+          *failure = SCHEDULER_FAILURE_SAVE;
+          result = false;
+          goto exit;
+        }
+        goto execute;
+      }
+
+      if (false == scheduler_trylock(self))
       {
 #if defined(NDEBUG)
         fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: cannot acquire the lock");
 #endif/*NDEBUG*/
-        command_destroy(command);
+        command_pool_release(self->pool, command);
         command = NULL;
         *failure = SCHEDULER_FAILURE_SAVE;
         result = false;
@@ -257,23 +559,22 @@ bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const
 #if defined(NDEBUG)
         fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: inbound queue exception");
 #endif/*NDEBUG*/
-        command_destroy(command);
+        command_pool_release(self->pool, command);
         command = NULL;
         *failure = SCHEDULER_FAILURE_SAVE;
         result = false;
         goto done;
       }
 
-      self->w_sched++;
-
       if (sem_post(&self->lock) < 0)
       {
         fprintf(stderr, "%s(): %s\n", "could not unblock on sem_post()");
         exit(EXIT_FAILURE);
       }
 
+execute:
     case SCHEDULER_STATE_EXECUTE:
-      retval = scheduler_execute(self, COMMAND_TYPE_WRITE, &status);
+      scheduler_execute(self, COMMAND_TYPE_WRITE, i, &status, rejected);
 
       switch (status)
       {
@@ -288,27 +589,15 @@ bool scheduler_enqueue(scheduler_t *self, const uint64_t i, int *failure, const
           result = false;
           break;
 
-        case SCHEDULER_STATUS_NODEFECT:
-          if (NULL == retval)
-          {
+        case SCHEDULER_STATUS_REJECTED:
 #if defined(NDEBUG)
-            fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: null enqueue result");
+          fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: invalid enqueue result");
 #endif/*NDEBUG*/
-            *failure = SCHEDULER_FAILURE_EXECUTE;
-            result = false;
-            break;
-          }
-          if (false == *(bool *)retval)
-          {
-#if defined(NDEBUG)
-            fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: invalid enqueue result");
-#endif/*NDEBUG*/
-            *failure = SCHEDULER_FAILURE_EXECUTE;
-            result = false;
-            break;
-          }
-          free(retval);
-          retval = NULL;
+          *failure = SCHEDULER_FAILURE_REJECTED;
+          result = false;
+          break;
+
+        case SCHEDULER_STATUS_NODEFECT:
           *failure = SCHEDULER_FAILURE_NODEFECT;
           result = true;
           break;
@@ -358,17 +647,34 @@ void *scheduler_dequeue(scheduler_t *self, const uint64_t i, int *failure, const
   bool result = false;
   int status = SCHEDULER_STATUS_INITIALIZED;
 
-  command = command_new(COMMAND_STATUS_UNSCHEDULED, i, command_reader, NULL);
-
   switch (state)
   {
     case SCHEDULER_STATE_SAVE:
-      if (sem_trywait(&self->lock) < 0)
+      command = command_pool_acquire(self->pool, COMMAND_STATUS_UNSCHEDULED, i, command_reader, NULL);
+
+      if (self->mode != SCHEDULER_MODE_LOCKED)
+      {
+        command->status = COMMAND_STATUS_SCHEDULED;
+        if (false == mpmc_ring_enqueue(self->shards[i].outbound, command))
+        {
+#if defined(NDEBUG)
+          fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: outbound ring exception");
+#endif/*NDEBUG*/
+          command_pool_release(self->pool, command);
+          command = NULL;
+          *failure = SCHEDULER_FAILURE_SAVE;
+          result = false;
+          goto exit;
+        }
+        goto execute;
+      }
+
+      if (false == scheduler_trylock(self))
       {
 #if defined(NDEBUG)
         fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: cannot acquire the lock");
 #endif/*NDEBUG*/
-        command_destroy(command);
+        command_pool_release(self->pool, command);
         command = NULL;
         *failure = SCHEDULER_FAILURE_SAVE;
         result = false;
@@ -382,23 +688,22 @@ void *scheduler_dequeue(scheduler_t *self, const uint64_t i, int *failure, const
 #if defined(NDEBUG)
         fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: outbound queue exception");
 #endif/*NDEBUG*/
-        command_destroy(command);
+        command_pool_release(self->pool, command);
         command = NULL;
         *failure = SCHEDULER_FAILURE_SAVE;
         result = false;
         goto done;
       }
 
-      self->r_sched++;
-
       if (sem_post(&self->lock) < 0)
       {
         fprintf(stderr, "%s(): %s\n", "could not unblock on sem_post()");
         exit(EXIT_FAILURE);
       }
 
+execute:
     case SCHEDULER_STATE_EXECUTE:
-      data = scheduler_execute(self, COMMAND_TYPE_READ, &status);
+      data = scheduler_execute(self, COMMAND_TYPE_READ, i, &status, NULL);
 
       switch (status)
       {
@@ -444,6 +749,159 @@ exit:
   return data;
 }
 
+/**
+ * @note The locked mode only tries the semaphore once, like every other
+ *       schedule attempt. The ring modes spin on the target flag since
+ *       it is only ever held for the duration of a single command.
+ */
+static bool scheduler_acquire(scheduler_t *self, const uint64_t i)
+{
+  if (self->mode != SCHEDULER_MODE_LOCKED)
+  {
+    scheduler_claim(self, i);
+    return true;
+  }
+
+  return scheduler_trylock(self);
+}
+
+static void scheduler_release(scheduler_t *self, const uint64_t i)
+{
+  if (self->mode != SCHEDULER_MODE_LOCKED)
+  {
+    scheduler_unclaim(self, i);
+    return;
+  }
+
+  if (sem_post(&self->lock) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not unblock on sem_post()");
+    exit(EXIT_FAILURE);
+  }
+}
+
+size_t scheduler_enqueue_many(scheduler_t *self, const uint64_t i, int *failure, const void **data, const size_t n)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (failure == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "failure state pointer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  command_t command;
+  bipartite_queue_t *target = NULL;
+
+  target = scheduler_get(self, i);
+  if (target == NULL)
+  {
+    *failure = SCHEDULER_FAILURE_EXECUTE;
+    return 0UL;
+  }
+
+  if (n == 0UL)
+  {
+    *failure = SCHEDULER_FAILURE_SUCCESSFUL;
+    return 0UL;
+  }
+
+  if (false == scheduler_acquire(self, i))
+  {
+#if defined(NDEBUG)
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: cannot acquire the lock");
+#endif/*NDEBUG*/
+    *failure = SCHEDULER_FAILURE_SAVE;
+    return 0UL;
+  }
+
+  command.status = COMMAND_STATUS_SCHEDULED;
+  command.result = COMMAND_RESULT_NONE;
+  command.channel_id = i;
+  command.callback = command_batch_writer;
+  command.parameter = (void *)data;
+  command.count = n;
+
+  command.callback(&command, target, SCHEDULER_COMMAND_PROBE_FALSE);
+  scheduler_produced(self, i, command.count);
+
+  scheduler_release(self, i);
+
+  if (COMMAND_RESULT_SUCCESS != command.result)
+  {
+    *failure = SCHEDULER_FAILURE_REJECTED;
+    return 0UL;
+  }
+
+  self->counter += command.count;
+  *failure = SCHEDULER_FAILURE_NODEFECT;
+
+  return command.count;
+}
+
+size_t scheduler_dequeue_many(scheduler_t *self, const uint64_t i, int *failure, void **out, const size_t max)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (failure == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "failure state pointer may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  command_t command;
+  bipartite_queue_t *target = NULL;
+
+  target = scheduler_get(self, i);
+  if (target == NULL)
+  {
+    *failure = SCHEDULER_FAILURE_EXECUTE;
+    return 0UL;
+  }
+
+  if (max == 0UL)
+  {
+    *failure = SCHEDULER_FAILURE_SUCCESSFUL;
+    return 0UL;
+  }
+
+  if (false == scheduler_acquire(self, i))
+  {
+#if defined(NDEBUG)
+    fprintf(stdout, "%s %s(): %s\n", "[info]", __func__, "scheduler: cannot acquire the lock");
+#endif/*NDEBUG*/
+    *failure = SCHEDULER_FAILURE_SAVE;
+    return 0UL;
+  }
+
+  command.status = COMMAND_STATUS_SCHEDULED;
+  command.result = COMMAND_RESULT_NONE;
+  command.channel_id = i;
+  command.callback = command_batch_reader;
+  command.parameter = (void *)out;
+  command.count = max;
+
+  command.callback(&command, target, SCHEDULER_COMMAND_PROBE_FALSE);
+  scheduler_consumed(self, i, command.count);
+
+  scheduler_release(self, i);
+
+  self->counter -= command.count;
+  *failure = (command.count > 0UL)
+    ? SCHEDULER_FAILURE_NODEFECT
+    : SCHEDULER_FAILURE_SUCCESSFUL;
+
+  return command.count;
+}
+
 void scheduler_add(scheduler_t *self, bipartite_queue_t *target)
 {
   if (self == NULL)
@@ -489,7 +947,19 @@ bool scheduler_empty(scheduler_t *self, const int i)
   bipartite_queue_t *target = NULL;
   target = scheduler_get(self, i);
 
-  if (sem_trywait(&self->lock) < 0)
+  if (self->mode != SCHEDULER_MODE_LOCKED)
+  {
+    if (atomic_flag_test_and_set_explicit(&self->shards[i].busy, memory_order_acquire))
+    {
+      return false;
+    }
+
+    const bool result = bipartite_queue_empty(target);
+    scheduler_unclaim(self, i);
+    return result;
+  }
+
+  if (false == scheduler_trylock(self))
   {
     return false;
   }
@@ -504,3 +974,89 @@ bool scheduler_empty(scheduler_t *self, const int i)
 
   return result;
 }
+
+uint64_t scheduler_depth(scheduler_t *self, const uint64_t i)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  if (i >= self->max_targets)
+  {
+    fprintf(stderr, "%s(%lu): %s\n", __func__, i, "index is out of bounds");
+    return 0UL;
+  }
+
+  return atomic_load_explicit(&self->shards[i].depth, memory_order_relaxed);
+}
+
+static int64_t scheduler_clock_ms(void)
+{
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not read the monotonic clock");
+    exit(EXIT_FAILURE);
+  }
+
+  return ((int64_t)ts.tv_sec * 1000L) + ((int64_t)ts.tv_nsec / 1000000L);
+}
+
+uint64_t scheduler_drain(scheduler_t *self, const uint64_t n, const long timeout_ms)
+{
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "scheduler instance may not be null");
+    exit(EXIT_FAILURE);
+  }
+
+  struct timespec timeout;
+  int64_t deadline = 0;
+  int64_t remaining = 0;
+  uint64_t queued;
+  unsigned int seq;
+  uint64_t i;
+
+  if (timeout_ms >= 0)
+  {
+    deadline = scheduler_clock_ms() + timeout_ms;
+  }
+
+  for (;;)
+  {
+    seq = atomic_load(&self->drained);
+    queued = 0UL;
+
+    for (i = 0; i < n && i < self->max_targets; i++)
+    {
+      queued += atomic_load(&self->shards[i].depth);
+    }
+
+    if (queued == 0UL)
+    {
+      break;
+    }
+
+    if (timeout_ms >= 0)
+    {
+      remaining = deadline - scheduler_clock_ms();
+
+      if (remaining <= 0)
+      {
+        break;
+      }
+
+      timeout.tv_sec = remaining / 1000L;
+      timeout.tv_nsec = (remaining % 1000L) * 1000000L;
+    }
+
+    atomic_fetch_add(&self->drain_waiters, 1U);
+    futex_wait_timed(&self->drained, seq, (timeout_ms >= 0) ? &timeout : NULL);
+    atomic_fetch_sub(&self->drain_waiters, 1U);
+  }
+
+  return queued;
+}
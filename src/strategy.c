@@ -0,0 +1,241 @@
+#include "common.h"
+#include "internal/hash_ring.h"
+#include "internal/min_heap.h"
+#include "load_balance.h"
+#include "strategy.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STRATEGY_SEED    0x9E3779B97F4A7C15UL
+
+static void strategy_release(void *state)
+{
+  __free(state);
+}
+
+static void *round_robin_create(const load_balancer_t *lb)
+{
+  (void)lb;
+
+  return _calloc(1, sizeof(uint64_t));
+}
+
+static uint64_t round_robin_select(const load_balancer_t *lb, void *state, const uint64_t key)
+{
+  uint64_t *cursor = state;
+  const uint64_t k = *cursor;
+
+  (void)key;
+
+  *cursor = (1UL + k) % lb->cap;
+
+  return k;
+}
+
+const strategy_t strategy_round_robin = {
+  .create = &round_robin_create,
+  .destroy = &strategy_release,
+  .select = &round_robin_select,
+};
+
+static void *least_loaded_create(const load_balancer_t *lb)
+{
+  return min_heap_new(lb->distribution, lb->cap);
+}
+
+static void least_loaded_destroy(void *state)
+{
+  min_heap_destroy(state);
+}
+
+static uint64_t least_loaded_select(const load_balancer_t *lb, void *state, const uint64_t key)
+{
+  (void)lb;
+  (void)key;
+
+  return min_heap_peek(state);
+}
+
+static void least_loaded_update(const load_balancer_t *lb, void *state, const uint64_t k, const uint64_t n)
+{
+  (void)lb;
+  (void)n;
+
+  min_heap_update(state, k);
+}
+
+/**
+ * @brief Split n items over the channels so that every channel ends up
+ *        as close as possible to the same outstanding count. The plan is
+ *        computed once per batch, quota[k] receives the run length of
+ *        channel k and the quotas sum to n.
+ */
+static void least_loaded_plan(const load_balancer_t *lb, void *state, size_t *quota, const size_t n)
+{
+  uint64_t total = n;
+  uint64_t level;
+  size_t remaining = n;
+  uint64_t k;
+
+  (void)state;
+
+  for (k = 0; k < lb->cap; k++)
+  {
+    total += lb->distribution[k];
+  }
+
+  level = (total + lb->cap - 1UL) / lb->cap;
+
+  for (k = 0; k < lb->cap; k++)
+  {
+    quota[k] = 0UL;
+
+    if (remaining == 0UL || lb->distribution[k] >= level)
+    {
+      continue;
+    }
+
+    quota[k] = level - lb->distribution[k];
+
+    if (quota[k] > remaining)
+    {
+      quota[k] = remaining;
+    }
+
+    remaining -= quota[k];
+  }
+}
+
+const strategy_t strategy_least_loaded = {
+  .create = &least_loaded_create,
+  .destroy = &least_loaded_destroy,
+  .select = &least_loaded_select,
+  .on_delivered = &least_loaded_update,
+  .on_acked = &least_loaded_update,
+  .plan = &least_loaded_plan,
+};
+
+static void *two_choices_create(const load_balancer_t *lb)
+{
+  uint64_t *seed = NULL;
+  seed = (uint64_t *)_calloc(1, sizeof(*seed));
+
+  (void)lb;
+
+  *seed = STRATEGY_SEED;
+  return seed;
+}
+
+static uint64_t two_choices_random(uint64_t *seed)
+{
+  uint64_t x = *seed;
+
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+
+  *seed = x;
+
+  return x * 0x2545F4914F6CDD1DUL;
+}
+
+static uint64_t two_choices_select(const load_balancer_t *lb, void *state, const uint64_t key)
+{
+  uint64_t a;
+  uint64_t b;
+
+  (void)key;
+
+  if (lb->cap < 2UL)
+  {
+    return 0UL;
+  }
+
+  a = two_choices_random(state) % lb->cap;
+  b = two_choices_random(state) % (lb->cap - 1UL);
+
+  if (b >= a)
+  {
+    b++;
+  }
+
+  return (lb->distribution[b] < lb->distribution[a]) ? b : a;
+}
+
+const strategy_t strategy_two_choices = {
+  .create = &two_choices_create,
+  .destroy = &strategy_release,
+  .select = &two_choices_select,
+};
+
+static void *weighted_create(const load_balancer_t *lb)
+{
+  return _calloc(lb->cap, sizeof(int64_t));
+}
+
+/**
+ * @note Every pick raises each channel by its weight and lowers the winner
+ *       by the total, which spreads a 5:1:1 split as a,a,b,a,c,a,a rather
+ *       than five a in a row.
+ */
+static uint64_t weighted_select(const load_balancer_t *lb, void *state, const uint64_t key)
+{
+  int64_t *current = state;
+  int64_t total = 0;
+  uint64_t best = 0UL;
+  uint64_t k;
+
+  (void)key;
+
+  for (k = 0; k < lb->cap; k++)
+  {
+    current[k] += (int64_t)lb->weights[k];
+    total += (int64_t)lb->weights[k];
+
+    if (current[k] > current[best])
+    {
+      best = k;
+    }
+  }
+
+  current[best] -= total;
+
+  return best;
+}
+
+const strategy_t strategy_weighted = {
+  .create = &weighted_create,
+  .destroy = &strategy_release,
+  .select = &weighted_select,
+};
+
+static void *consistent_hash_create(const load_balancer_t *lb)
+{
+  (void)lb;
+
+  return NULL;
+}
+
+static uint64_t consistent_hash_select(const load_balancer_t *lb, void *state, const uint64_t key)
+{
+  uint64_t k;
+
+  (void)state;
+
+  if (false == hash_ring_lookup(lb->ring, key, &k))
+  {
+    k = hash_ring_hash(key) % lb->cap;
+  }
+
+  return k;
+}
+
+const strategy_t strategy_consistent_hash = {
+  .create = &consistent_hash_create,
+  .destroy = &strategy_release,
+  .select = &consistent_hash_select,
+};
@@ -0,0 +1,119 @@
+#include "channel.h"
+#include "observable.h"
+#include "observer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define WORK_LOAD       20000
+#define QUEUE_CAPACITY  (16 * sizeof(int))
+#define MAX_OBSERVERS   2
+
+/**
+ * @note Channels of 16 items against 20000 publishes keep the targets
+ *       full for most of the run, so nearly every write goes through a
+ *       rejection and the retry engine at least once.
+ */
+static atomic_uint seen[WORK_LOAD];
+
+static void on_items(observer_t *observer, void **items, const size_t n)
+{
+  size_t j;
+
+  (void)observer;
+
+  for (j = 0; j < n; j++)
+  {
+    atomic_fetch_add(&seen[*(int *)items[j]], 1U);
+    free(items[j]);
+  }
+}
+
+static void *notifier(void *args)
+{
+  observer_run((observer_t *)args, &on_items);
+  return NULL;
+}
+
+static bool test_every_item_arrives(const char *name, const int flags)
+{
+  observable_t *observable = NULL;
+  observable = observable_new(QUEUE_CAPACITY, MAX_OBSERVERS, MAX_OBSERVERS, flags);
+
+  pthread_t tids[MAX_OBSERVERS];
+  int *values = NULL;
+  uint64_t i;
+
+  bool passed = true;
+
+  for (i = 0; i < MAX_OBSERVERS; i++)
+  {
+    observable_subscribe(observable, observer_new(observable, observable->channels[i], &notifier, i));
+
+    if (pthread_create(&tids[i], NULL, &notifier, observable->observers[i]) < 0)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not create thread");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  values = (int *)calloc(WORK_LOAD, sizeof(*values));
+
+  for (i = 0; i < WORK_LOAD; i++)
+  {
+    atomic_init(&seen[i], 0U);
+    values[i] = (int)i;
+  }
+
+  for (i = 0; i < WORK_LOAD; i++)
+  {
+    if (false == observable_publish(observable, &values[i]))
+    {
+      passed = false;
+    }
+  }
+
+  observable_cleanup(observable);
+
+  if (0UL != observable_shutdown(observable, 10000L))
+  {
+    passed = false;
+  }
+
+  for (i = 0; i < MAX_OBSERVERS; i++)
+  {
+    pthread_join(tids[i], NULL);
+  }
+
+  for (i = 0; i < WORK_LOAD; i++)
+  {
+    if (1U != atomic_load(&seen[i]))
+    {
+      fprintf(stderr, "%s(): item %lu arrived %u times\n", name, i, atomic_load(&seen[i]));
+      passed = false;
+      break;
+    }
+  }
+
+  printf("%s %s\n", (passed) ? "[pass]" : "[fail]", name);
+
+  observable_destroy(observable);
+  free(values);
+
+  return passed;
+}
+
+int main(void)
+{
+  bool passed = true;
+
+  passed &= test_every_item_arrives("locked", OBSERVABLE_FLAG_NONE);
+  passed &= test_every_item_arrives("lock_free", OBSERVABLE_FLAG_LOCK_FREE);
+  passed &= test_every_item_arrives("sharded", OBSERVABLE_FLAG_SHARDED);
+
+  return (passed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}